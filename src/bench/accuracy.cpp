@@ -0,0 +1,169 @@
+﻿/*! \file accuracy.cpp
+    \brief 計算条件ごとの、既知の普遍定数に対する誤差と計算時間を表にまとめるクラスの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "accuracy.h"
+#include "../thomasfermi/solver.h"
+#include <algorithm>            // for std::sort
+#include <chrono>               // for std::chrono
+#include <cmath>                // for std::fabs, std::sqrt
+#include <iostream>             // for std::cout
+#include <limits>               // for std::numeric_limits
+#include <memory>               // for std::make_shared
+#include <stdexcept>            // for std::runtime_error
+#include <boost/format.hpp>     // for boost::format
+
+namespace thomasfermi {
+    namespace bench {
+        // #region コンストラクタ
+
+        Accuracy::Accuracy(std::vector<std::uint32_t> const & grids, std::vector<double> const & xmaxs, std::vector<double> const & weights)
+            :   grids_(grids),
+                weights_(weights),
+                xmaxs_(xmaxs)
+        {
+        }
+
+        // #endregion コンストラクタ
+
+        // #region publicメンバ関数
+
+        double Accuracy::operator()(FILE * fp)
+        {
+            for (auto const grid : grids_) {
+                for (auto const xmax : xmaxs_) {
+                    for (auto const weight : weights_) {
+                        result_.push_back(solve(grid, xmax, weight));
+                    }
+                }
+            }
+
+            markpareto();
+
+            std::sort(result_.begin(), result_.end(), [](auto const & lhs, auto const & rhs) { return lhs.time < rhs.time; });
+
+            std::cout << boost::format("%-2s %10s %8s %8s %6s %12s %22s %12s %22s %12s\n")
+                % "" % "Grid" % "xmax" % "Weight" % "Iter" % "Time(ms)" % "y'(0)" % "Error" % "E / Z^(7/3)" % "Error";
+
+            if (fp) {
+                std::fprintf(fp, "grid,xmax,weight,converged,iteration,time_ms,yprime0,yprime0_error,energy,energy_error,pareto\n");
+            }
+
+            auto best = std::numeric_limits<double>::infinity();
+            for (auto const & r : result_) {
+                auto const yerror = std::fabs((r.yprime0 - Accuracy::YPRIME0_REFERENCE) / Accuracy::YPRIME0_REFERENCE);
+                auto const eerror = std::fabs((r.energy - Accuracy::ENERGY_REFERENCE) / Accuracy::ENERGY_REFERENCE);
+
+                if (r.converged) {
+                    best = std::min(best, eerror);
+                    std::cout << boost::format("%-2s %10d %8g %8g %6d %12.3f %22.15f %12.3e %22.15f %12.3e\n")
+                        % (r.pareto ? "*" : "") % r.grid % r.xmax % r.weight % r.iteration % r.time % r.yprime0 % yerror % r.energy % eerror;
+                }
+                else {
+                    std::cout << boost::format("%-2s %10d %8g %8g %6s %12.3f %22s %12s %22s %12s\n")
+                        % "" % r.grid % r.xmax % r.weight % "-" % r.time % "収束しませんでした" % "-" % "-" % "-";
+                }
+
+                if (fp && r.converged) {
+                    std::fprintf(fp, "%u,%g,%g,1,%u,%.6f,%.15f,%.6e,%.15f,%.6e,%d\n",
+                        r.grid, r.xmax, r.weight, r.iteration, r.time, r.yprime0, yerror, r.energy, eerror, r.pareto ? 1 : 0);
+                }
+                else if (fp) {
+                    // 収束しなかった組み合わせは、誤差の列を空にする
+                    std::fprintf(fp, "%u,%g,%g,0,,%.6f,,,,,0\n", r.grid, r.xmax, r.weight, r.time);
+                }
+            }
+
+            std::cout << "*: Paretoフロント（より速く、かつエネルギーの誤差がより小さい組み合わせがない）" << std::endl;
+
+            return best;
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+        void Accuracy::markpareto()
+        {
+            for (auto & r : result_) {
+                if (!r.converged) {
+                    continue;
+                }
+
+                auto const error = std::fabs(r.energy - Accuracy::ENERGY_REFERENCE);
+
+                r.pareto = true;
+                for (auto const & other : result_) {
+                    if (!other.converged || &other == &r) {
+                        continue;
+                    }
+
+                    auto const othererror = std::fabs(other.energy - Accuracy::ENERGY_REFERENCE);
+                    if (other.time <= r.time && othererror <= error && (other.time < r.time || othererror < error)) {
+                        r.pareto = false;
+                        break;
+                    }
+                }
+            }
+        }
+
+        Accuracy::Result Accuracy::solve(std::uint32_t grid, double xmax, double weight) const
+        {
+            auto const pdata = std::make_shared<Data>();
+            pdata->grid_num_ = grid;
+            pdata->xmax_ = xmax;
+            pdata->iteration_mixing_weight_ = weight;
+
+            Result r = {};
+            r.grid = grid;
+            r.xmax = xmax;
+            r.weight = weight;
+
+            // 前の組み合わせの解を初期関数にしないように、組み合わせごとにソルバーを作る
+            auto const start = std::chrono::high_resolution_clock::now();
+            try {
+                Solver solver(pdata);
+                r.iteration = solver.solve();
+
+                std::vector<double> x(solver.size()), y(solver.size());
+                solver.y(x.data(), y.data());
+                r.yprime0 = Accuracy::yprime0(x, y);
+
+                // y(x)は原子番号によらないので、Z = 1のエネルギーがZ^(7/3)の係数になる
+                auto const [t, ene, eee] = solver.energy(1.0);
+                r.energy = t + ene + eee;
+                r.converged = true;
+            }
+            catch (std::runtime_error const &) {
+            }
+
+            r.time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+            return r;
+        }
+
+        double Accuracy::yprime0(std::vector<double> const & x, std::vector<double> const & y)
+        {
+            // (y - 1 - (4/3)x^(3/2) - (1/3)x^3) / x = B(1 + (2/5)x^(3/2)) + O(x^(5/2))
+            auto const x1 = x[1];
+            auto const s = x1 * std::sqrt(x1);
+            return (y[1] - 1.0 - 4.0 / 3.0 * s - x1 * x1 * x1 / 3.0) / (x1 * (1.0 + 0.4 * s));
+        }
+
+        // #endregion privateメンバ関数
+    }
+}
@@ -0,0 +1,185 @@
+﻿/*! \file accuracy.h
+    \brief 計算条件ごとの、既知の普遍定数に対する誤差と計算時間を表にまとめるクラスの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _ACCURACY_H_
+#define _ACCURACY_H_
+
+#pragma once
+
+#include <cstdint>      // for std::uint32_t
+#include <cstdio>       // for FILE
+#include <vector>       // for std::vector
+
+namespace thomasfermi {
+    namespace bench {
+        //! A class.
+        /*!
+            計算条件（メッシュの分割数、xの最大値、混合の重み）の組み合わせごとに孤立した中性原子を解き、
+            既知の普遍定数（y'(0)とエネルギーのZ^(7/3)の係数）に対する誤差と計算時間を表にまとめるクラス
+            時間と誤差のどちらでも他の組み合わせに劣らない組み合わせ（Paretoフロント）に印を付ける
+        */
+        class Accuracy final {
+            // #region コンストラクタ・デストラクタ
+
+        public:
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param grids メッシュの分割数
+                \param xmaxs xの最大値
+                \param weights 一次混合の重み
+            */
+            Accuracy(std::vector<std::uint32_t> const & grids, std::vector<double> const & xmaxs, std::vector<double> const & weights);
+
+            //! A default destructor.
+            /*!
+                デフォルトデストラクタ
+            */
+            ~Accuracy() = default;
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region publicメンバ関数
+
+            //! A public member function.
+            /*!
+                すべての組み合わせを解いて、計算時間の順に表を表示する
+                \param fp 結果をCSV形式でも書き込むファイル（書き込まないときはnullptr）
+                \return 収束した組み合わせの中で最も小さいエネルギーの相対誤差（一つも収束しなければ無限大）
+            */
+            double operator()(FILE * fp);
+
+            // #endregion publicメンバ関数
+
+            // #region privateメンバ関数
+
+        private:
+            //! A struct.
+            /*!
+                一つの組み合わせの結果
+            */
+            struct Result final {
+                std::uint32_t grid;         //!< メッシュの分割数
+                double xmax;                //!< xの最大値
+                double weight;              //!< 一次混合の重み
+                bool converged;             //!< 収束したかどうか
+                std::uint32_t iteration;    //!< 反復回数
+                double time;                //!< 計算時間（msec）
+                double yprime0;             //!< y'(0)
+                double energy;              //!< エネルギーのZ^(7/3)の係数
+                bool pareto;                //!< Paretoフロントに含まれるかどうか
+            };
+
+            //! A private member function.
+            /*!
+                Paretoフロントに含まれる組み合わせに印を付ける
+            */
+            void markpareto();
+
+            //! A private member function (const).
+            /*!
+                一つの組み合わせを解く
+                \param grid メッシュの分割数
+                \param xmax xの最大値
+                \param weight 一次混合の重み
+                \return 結果
+            */
+            Result solve(std::uint32_t grid, double xmax, double weight) const;
+
+            //! A private static member function.
+            /*!
+                原点の近くの展開y = 1 + Bx + (4/3)x^(3/2) + (2/5)Bx^(5/2) + (1/3)x^3 + ...から、
+                メッシュの二番目の節点の値を使ってy'(0) = Bを求める（差分商より誤差の次数が高い）
+                \param x x方向のメッシュ
+                \param y 各節点におけるy(x)の値
+                \return y'(0)
+            */
+            static double yprime0(std::vector<double> const & x, std::vector<double> const & y);
+
+            // #endregion privateメンバ関数
+
+            // #region メンバ変数
+
+            //! A private member variable (constant expression).
+            /*!
+                y'(0)の高精度な参照値
+            */
+            static auto constexpr YPRIME0_REFERENCE = -1.588071022611375;
+
+            //! A private member variable (constant expression).
+            /*!
+                エネルギーのZ^(7/3)の係数の参照値（3 / 7 * y'(0) / b、b = (9π^2 / 128)^(1/3)）
+            */
+            static auto constexpr ENERGY_REFERENCE = -0.7687451242136615;
+
+            //! A private member variable (constant).
+            /*!
+                メッシュの分割数
+            */
+            std::vector<std::uint32_t> const grids_;
+
+            //! A private member variable.
+            /*!
+                結果
+            */
+            std::vector<Result> result_;
+
+            //! A private member variable (constant).
+            /*!
+                一次混合の重み
+            */
+            std::vector<double> const weights_;
+
+            //! A private member variable (constant).
+            /*!
+                xの最大値
+            */
+            std::vector<double> const xmaxs_;
+
+            // #endregion メンバ変数
+
+            // #region 禁止されたコンストラクタ・メンバ関数
+
+        public:
+            //! A default constructor (deleted).
+            /*!
+                デフォルトコンストラクタ（禁止）
+            */
+            Accuracy() = delete;
+
+            //! A copy constructor (deleted).
+            /*!
+                コピーコンストラクタ（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+            */
+            Accuracy(Accuracy const & dummy) = delete;
+
+            //! A public member function (deleted).
+            /*!
+                operator=()の宣言（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+                \return コピー元のオブジェクト
+            */
+            Accuracy & operator=(Accuracy const & dummy) = delete;
+
+            // #endregion 禁止されたコンストラクタ・メンバ関数
+        };
+    }
+}
+
+#endif  // _ACCURACY_H_
@@ -0,0 +1,189 @@
+﻿/*! \file benchmark.h
+    \brief カーネルの時間を測って、一要素あたりの時間と実効帯域を表示するクラスの宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _BENCHMARK_H_
+#define _BENCHMARK_H_
+
+#pragma once
+
+#include <algorithm>        // for std::sort
+#include <chrono>           // for std::chrono
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uint32_t
+#include <cstdio>           // for FILE, std::fprintf
+#include <string>           // for std::string
+#include <vector>           // for std::vector
+#include <iostream>         // for std::cout
+#include <boost/format.hpp> // for boost::format
+
+namespace thomasfermi {
+    namespace bench {
+        //! A class.
+        /*!
+            カーネルを繰り返し実行して時間を測り、一要素あたりの時間と実効帯域を表示するクラス
+            一回の実行時間の中央値を使う（最初の一回はキャッシュを温めるために捨てる）
+            GB/sは、カーネルが最低限読み書きしなければならないバイト数を中央値で割った値
+        */
+        class Benchmark final {
+            // #region コンストラクタ・デストラクタ
+
+        public:
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param mintime 一つのカーネルを繰り返す最小の時間（秒）
+                \param fp 結果をCSV形式でも書き込むファイル（書き込まないときはnullptr）
+            */
+            Benchmark(double mintime, FILE * fp)
+                :   fp_(fp),
+                    mintime_(mintime)
+            {
+                std::cout << boost::format("%-24s %10s %8s %8s %12s %12s %10s\n")
+                    % "Kernel" % "Grid" % "Threads" % "Reps" % "Median(ms)" % "ns/element" % "GB/s";
+
+                if (fp_) {
+                    std::fprintf(fp_, "kernel,grid,threads,reps,median_ms,ns_per_element,gb_per_s\n");
+                }
+            }
+
+            //! A default destructor.
+            /*!
+                デフォルトデストラクタ
+            */
+            ~Benchmark() = default;
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region publicメンバ関数
+
+            template <typename Setup, typename Kernel>
+            //! A public member function (template function).
+            /*!
+                準備の関数を呼んだ後にカーネルを実行することを繰り返して、カーネルの時間だけを測る
+                \param name カーネルの名前
+                \param grid メッシュの分割数
+                \param threads スレッド数
+                \param elements 一回の実行で処理する要素の数
+                \param bytes 一回の実行で最低限読み書きするバイト数
+                \param setup 準備の関数（時間に含めない）
+                \param kernel 測るカーネル
+            */
+            void operator()(char const * name, std::uint32_t grid, std::int32_t threads, std::size_t elements, double bytes, Setup && setup, Kernel && kernel)
+            {
+                using namespace std::chrono;
+
+                setup();
+                kernel();
+
+                std::vector<double> samples;
+                auto total = 0.0;
+                while (samples.size() < Benchmark::MINREPS || total < mintime_) {
+                    setup();
+
+                    auto const start = high_resolution_clock::now();
+                    kernel();
+                    auto const elapsed = duration_cast< duration<double> >(high_resolution_clock::now() - start).count();
+
+                    samples.push_back(elapsed);
+                    total += elapsed;
+                }
+
+                std::sort(samples.begin(), samples.end());
+                auto const median = samples[samples.size() / 2];
+                auto const nsperelement = median * 1.0E+9 / static_cast<double>(elements);
+                auto const gbpers = bytes / median * 1.0E-9;
+
+                std::cout << boost::format("%-24s %10d %8d %8d %12.4f %12.3f %10.3f\n")
+                    % name % grid % threads % samples.size() % (median * 1000.0) % nsperelement % gbpers << std::flush;
+
+                if (fp_) {
+                    std::fprintf(fp_, "%s,%u,%d,%zu,%.6f,%.6f,%.6f\n", name, grid, threads, samples.size(), median * 1000.0, nsperelement, gbpers);
+                }
+            }
+
+            template <typename Kernel>
+            //! A public member function (template function).
+            /*!
+                準備の要らないカーネルを繰り返し実行して時間を測る
+                \param name カーネルの名前
+                \param grid メッシュの分割数
+                \param threads スレッド数
+                \param elements 一回の実行で処理する要素の数
+                \param bytes 一回の実行で最低限読み書きするバイト数
+                \param kernel 測るカーネル
+            */
+            void operator()(char const * name, std::uint32_t grid, std::int32_t threads, std::size_t elements, double bytes, Kernel && kernel)
+            {
+                (*this)(name, grid, threads, elements, bytes, [] {}, kernel);
+            }
+
+            // #endregion publicメンバ関数
+
+            // #region メンバ変数
+
+        private:
+            //! A private member variable (constant expression).
+            /*!
+                最小の繰り返し回数
+            */
+            static std::size_t constexpr MINREPS = 5;
+
+            //! A private member variable.
+            /*!
+                結果をCSV形式でも書き込むファイル
+            */
+            FILE * const fp_;
+
+            //! A private member variable (constant).
+            /*!
+                一つのカーネルを繰り返す最小の時間（秒）
+            */
+            double const mintime_;
+
+            // #endregion メンバ変数
+
+            // #region 禁止されたコンストラクタ・メンバ関数
+
+        public:
+            //! A default constructor (deleted).
+            /*!
+                デフォルトコンストラクタ（禁止）
+            */
+            Benchmark() = delete;
+
+            //! A copy constructor (deleted).
+            /*!
+                コピーコンストラクタ（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+            */
+            Benchmark(Benchmark const & dummy) = delete;
+
+            //! A public member function (deleted).
+            /*!
+                operator=()の宣言（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+                \return コピー元のオブジェクト
+            */
+            Benchmark & operator=(Benchmark const & dummy) = delete;
+
+            // #endregion 禁止されたコンストラクタ・メンバ関数
+        };
+    }
+}
+
+#endif  // _BENCHMARK_H_
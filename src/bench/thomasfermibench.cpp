@@ -0,0 +1,314 @@
+﻿/*! \file thomasfermibench.cpp
+    \brief 有限要素法の主要なカーネルのマイクロベンチマーク
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "accuracy.h"
+#include "benchmark.h"
+#include "../thomasfermi/beta.h"
+#include "../thomasfermi/data.h"
+#include "../thomasfermi/foelement.h"
+#include "../thomasfermi/gausslegendre/gausslegendre.h"
+#include "../thomasfermi/linearequations.h"
+#include "../thomasfermi/makerhoen/makerhoenergy.h"
+#include "../thomasfermi/myfunctional/functional.h"
+#include "../thomasfermi/shoot/shootf.h"
+#include "../thomasfermi/soelement.h"
+#include <cmath>                                // for std::sqrt
+#include <cstdint>                              // for std::int32_t, std::uint32_t
+#include <cstdio>                               // for std::fclose, std::fopen
+#include <cstdlib>                              // for EXIT_FAILURE, EXIT_SUCCESS
+#include <iostream>                             // for std::cerr, std::cout
+#include <memory>                               // for std::unique_ptr
+#include <string>                               // for std::string
+#include <tuple>                                // for std::make_tuple
+#include <vector>                               // for std::vector
+#include <boost/format.hpp>                     // for boost::format
+#include <boost/program_options.hpp>            // for boost::program_options
+#include <omp.h>                                // for omp_get_max_threads, omp_set_num_threads
+
+namespace thomasfermi {
+    namespace bench {
+        //! A function.
+        /*!
+            名前がfilterのいずれかを含むかどうか（filterが空なら常にtrue）
+            \param name カーネルの名前
+            \param filter 実行するカーネルの名前の一部
+            \return 実行するかどうか
+        */
+        bool selected(std::string const & name, std::vector<std::string> const & filter)
+        {
+            if (filter.empty()) {
+                return true;
+            }
+
+            for (auto const & f : filter) {
+                if (name.find(f) != std::string::npos) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        //! A function.
+        /*!
+            一つのメッシュの分割数とスレッド数について、すべてのカーネルを測る
+            y(x)はshooting法の結果を使う（反復の最初と同じ状態）
+            \param bench 時間を測るオブジェクト
+            \param grid メッシュの分割数
+            \param threads スレッド数
+            \param filter 実行するカーネルの名前の一部
+        */
+        void run(Benchmark & bench, std::uint32_t grid, std::int32_t threads, std::vector<std::string> const & filter)
+        {
+            using namespace femall;
+            using namespace shoot;
+
+            auto const useomp = threads > 1;
+            omp_set_num_threads(threads);
+
+            // shooting法（Iterationのコンストラクタと同じ条件）
+            auto const dx = XMAX_DEFAULT / static_cast<double>(grid);
+            load2 l2;
+            shootf s(shootfunc::DELV, shootfunc::DELV, dx, shootfunc::DELV * 0.1, shootfunc::load1, l2, shootfunc::score, shootfunc::V1, l2.make_v2(XMAX_DEFAULT));
+
+            shootf::result_type result;
+            auto const shoot = [&] {
+                result.first.clear();
+                result.second.clear();
+#if _OPENMP >= 200805
+    #pragma omp parallel if (useomp)
+    #pragma omp single
+#endif
+                s(useomp, XMIN_DEFAULT, XMAX_DEFAULT, MATCH_POINT_DEFAULT, result);
+            };
+
+            auto const nnode = static_cast<std::size_t>(grid) + 1;
+            auto const dsize = static_cast<double>(sizeof(double));
+            if (selected("shootf", filter)) {
+                bench("shootf", grid, threads, nnode, 2.0 * dsize * static_cast<double>(nnode), shoot);
+            }
+            else {
+                shoot();
+            }
+
+            auto const & x(result.first);
+            auto const & y(result.second);
+            auto const n = x.size();
+
+            // Iteration::make_beta()と同じβ = y^(3/2) / √x
+            std::vector<double> beta(n);
+            for (auto i = 0U; i < n; i++) {
+                auto const yi = std::max(y[i], 0.0);
+                beta[i] = yi * std::sqrt(yi / x[i]);
+            }
+
+            // β(x)の参照は、各要素の中点で行う（二分探索の深さはメッシュの大きさで決まる）
+            std::vector<double> xq(n - 1), out(n - 1);
+            for (auto i = 0U; i < n - 1; i++) {
+                xq[i] = 0.5 * (x[i] + x[i + 1]);
+            }
+
+            Beta const b(x, beta);
+            auto const nq = static_cast<std::int32_t>(xq.size());
+            if (selected("beta_first", filter)) {
+                bench("beta_first", grid, threads, xq.size(), 6.0 * dsize * static_cast<double>(nq), [&] {
+#pragma omp parallel for if (useomp)
+                    for (auto i = 0; i < nq; i++) {
+                        out[i] = b.operator()<Element::First>(xq[i]);
+                    }
+                });
+            }
+
+            if (selected("beta_second", filter)) {
+                bench("beta_second", grid, threads, xq.size(), 8.0 * dsize * static_cast<double>(nq), [&] {
+#pragma omp parallel for if (useomp)
+                    for (auto i = 0; i < nq; i++) {
+                        out[i] = b.operator()<Element::Second>(xq[i]);
+                    }
+                });
+            }
+
+            // 一次要素（FOElement::getc()とFEM::createb()を全要素に対して呼ぶ）
+            FOElement fo(std::vector<double>(beta), x, GAUSS_LEGENDRE_INTEG_DEFAULT, useomp);
+            fo.stiff();
+            if (selected("stiff2_first", filter)) {
+                bench("stiff2_first", grid, threads, n - 1, 10.0 * dsize * static_cast<double>(n - 1),
+                      [&] { fo.reset(beta); }, [&] { fo.stiff2(); });
+            }
+
+            // 二次要素（節点数が奇数でなければならない）
+            if (n % 2 && selected("stiff2_second", filter)) {
+                SOElement so(std::vector<double>(beta), x, GAUSS_LEGENDRE_INTEG_DEFAULT, useomp);
+                so.stiff();
+                bench("stiff2_second", grid, threads, (n - 1) / 2, 15.0 * dsize * static_cast<double>((n - 1) / 2),
+                      [&] { so.reset(beta); }, [&] { so.stiff2(); });
+
+                Linear_equations le(so.createresult());
+                std::vector<std::size_t> const ibc = { 0, n - 1 };
+                std::vector<double> const vbc = { y.front(), y.back() };
+                if (selected("lesolver_second", filter)) {
+                    bench("lesolver_second", grid, threads, n, 14.0 * dsize * static_cast<double>(n),
+                          [&] { le.reset(so.B); le.bound<Element::Second>(2, ibc, 2, ibc, vbc); },
+                          [&] { le.LEsolver<Element::Second>(); });
+                }
+            }
+
+            if (selected("lesolver_first", filter)) {
+                fo.reset(beta);
+                fo.stiff2();
+
+                Linear_equations le(fo.createresult());
+                std::vector<std::size_t> const ibc = { 0, n - 1 };
+                std::vector<double> const vbc = { y.front(), y.back() };
+                bench("lesolver_first", grid, threads, n, 6.0 * dsize * static_cast<double>(n),
+                      [&] { le.reset(fo.B); le.bound<Element::First>(2, ibc, 2, ibc, vbc); },
+                      [&] { le.LEsolver<Element::First>(); });
+            }
+
+            // 要素ごとのGauss-Legendre積分（規格化の積分と同じく、区間ごとのy(x)の一次補間を積分する）
+            if (selected("qgauss", filter)) {
+                gausslegendre::Gauss_Legendre const gl(GAUSS_LEGENDRE_INTEG_DEFAULT);
+                auto const nelem = static_cast<std::int32_t>(n - 1);
+                std::vector<double> sum(n - 1);
+                bench("qgauss", grid, threads, n - 1, 4.0 * dsize * static_cast<double>(nelem), [&] {
+#pragma omp parallel for if (useomp)
+                    for (auto i = 0; i < nelem; i++) {
+                        auto const x0 = x[i], x1 = x[i + 1], y0 = y[i], y1 = y[i + 1];
+                        sum[i] = gl.qgauss(
+                            myfunctional::make_functional([=](double t) {
+                                auto const yt = y0 + (y1 - y0) * (t - x0) / (x1 - x0);
+                                return std::sqrt(t) * yt * std::sqrt(std::max(yt, 0.0));
+                            }),
+                            x0,
+                            x1);
+                    }
+                });
+            }
+
+            // 後処理（エネルギーの積分と、三つのCSVファイルの書き出し）
+            if (selected("makerhoenergy", filter)) {
+                auto const pt = std::make_tuple(x, y, (y[1] - y[0]) / (x[1] - x[0]));
+                bench("makerhoenergy", grid, threads, n, 8.0 * dsize * static_cast<double>(n), [&] {
+                    makerhoen::MakeRhoEnergy mre(GAUSS_LEGENDRE_INTEG_DEFAULT, pt, 1.0, useomp);
+                    mre.savefiles("_bench", false, 0.0);
+                });
+            }
+        }
+    }
+}
+
+int main(int argc, char * argv[])
+{
+    using namespace boost::program_options;
+
+    options_description opt("オプション");
+    opt.add_options()
+        ("accuracy,a", "マイクロベンチマークの代わりに、計算条件ごとの既知の普遍定数に対する誤差と計算時間の表を作る")
+        ("help,h", "ヘルプを表示")
+        ("grid,g", value< std::vector<std::uint32_t> >()->multitoken(), "メッシュの分割数（複数指定可、デフォルトは1000 10000 100000）")
+        ("threads,t", value< std::vector<std::int32_t> >()->multitoken(), "スレッド数（複数指定可、デフォルトは1と最大のスレッド数）")
+        ("kernel,k", value< std::vector<std::string> >()->multitoken(), "名前にこの文字列を含むカーネルだけを測る（複数指定可）")
+        ("time", value<double>()->default_value(0.2), "一つのカーネルを繰り返す最小の時間（秒）")
+        ("xmax", value< std::vector<double> >()->multitoken(), "--accuracyで使うxの最大値（複数指定可、デフォルトは50 100）")
+        ("weight", value< std::vector<double> >()->multitoken(), "--accuracyで使う一次混合の重み（複数指定可、デフォルトは0.08）")
+        ("max-error", value<double>(), "--accuracyで、最も小さいエネルギーの相対誤差がこの値を超えたら失敗として終了する")
+        ("csv,c", value<std::string>(), "結果をCSV形式でも書き込むファイル名");
+
+    variables_map vm;
+    try {
+        store(parse_command_line(argc, argv, opt), vm);
+        notify(vm);
+    } catch (std::exception const & e) {
+        std::cerr << e.what() << ". コマンドライン引数が異常です。終了します。" << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    if (vm.count("help")) {
+        std::cout << opt << "\nmakerhoenergyは、カレントディレクトリに*_bench.csvを書き出します。" << std::endl;
+
+        return EXIT_SUCCESS;
+    }
+
+    auto const accuracy = vm.count("accuracy") > 0;
+
+    auto const grids = vm.count("grid") ? vm["grid"].as< std::vector<std::uint32_t> >() :
+        accuracy ? std::vector<std::uint32_t>{ 2000, 5000, 10000, 20000, 50000, 100000 } : std::vector<std::uint32_t>{ 1000, 10000, 100000 };
+
+    auto threads = vm.count("threads") ? vm["threads"].as< std::vector<std::int32_t> >() : std::vector<std::int32_t>{ 1 };
+    if (!vm.count("threads") && omp_get_max_threads() > 1) {
+        threads.push_back(omp_get_max_threads());
+    }
+
+    auto const filter = vm.count("kernel") ? vm["kernel"].as< std::vector<std::string> >() : std::vector<std::string>();
+
+    std::unique_ptr<FILE, decltype(&std::fclose)> fp(nullptr, std::fclose);
+    if (vm.count("csv")) {
+        fp.reset(std::fopen(vm["csv"].as<std::string>().c_str(), "w"));
+        if (!fp) {
+            std::cerr << "ファイルが開けませんでした。" << std::endl;
+
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (accuracy) {
+        try {
+            auto const xmaxs = vm.count("xmax") ? vm["xmax"].as< std::vector<double> >() : std::vector<double>{ 50.0, 100.0 };
+            // 0.15ではxmax = 100が収束しないので、デフォルトは両方のxmaxで収束する重みだけにする
+            auto const weights = vm.count("weight") ? vm["weight"].as< std::vector<double> >() : std::vector<double>{ 0.08 };
+
+            auto const best = thomasfermi::bench::Accuracy(grids, xmaxs, weights)(fp.get());
+            if (vm.count("max-error") && !(best <= vm["max-error"].as<double>())) {
+                std::cerr << boost::format("エネルギーの相対誤差%.3eが、許容値%.3eを超えました。") % best % vm["max-error"].as<double>() << std::endl;
+
+                return EXIT_FAILURE;
+            }
+        } catch (std::exception const & e) {
+            std::cerr << e.what() << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    try {
+        thomasfermi::bench::Benchmark bench(vm["time"].as<double>(), fp.get());
+
+        // Gauss-Legendreの分点と重みの生成は、メッシュによらない（規格化の積分で使う分点の数で測る）
+        if (thomasfermi::bench::selected("gl_construct", filter)) {
+            auto const num = thomasfermi::GAUSS_LEGENDRE_INTEG_NORM_DEFAULT;
+            bench("gl_construct", num, 1, num, 2.0 * sizeof(double) * num, [num] {
+                gausslegendre::Gauss_Legendre const gl(static_cast<std::int32_t>(num));
+            });
+        }
+
+        for (auto const grid : grids) {
+            for (auto const t : threads) {
+                thomasfermi::bench::run(bench, grid, t, filter);
+            }
+        }
+    } catch (std::exception const & e) {
+        std::cerr << e.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -73,10 +73,14 @@ namespace checkpoint {
         //! A public static member function.
         /*!
             メモリを確保してそのアドレスを返す
-            \return 確保されたメモリのアドレス
+            \return 確保されたメモリのアドレス（空きがないときはnullptr）
         */
         static void * Alloc() {
             Item * ret = first_;
+            if (!ret) {
+                return nullptr;
+            }
+
             first_ = ret->next_;
             return reinterpret_cast<void *>(ret);
         }
@@ -17,10 +17,12 @@
 */
 
 #include "checkpoint.h"
+#include <algorithm>            // for std::stable_sort
+#include <cstdio>               // for std::fclose, std::fgets, std::fopen, std::fputs, std::sscanf
 #include <iostream>             // for std::cout
-#include <optional>             // for std::nullopt, std::optional
+#include <new>                  // for std::bad_alloc
+#include <optional>             // for std::make_optional, std::nullopt, std::optional
 #include <system_error>         // for std::system_category
-#include <boost/assert.hpp>        // for boost::assert
 #include <boost/cast.hpp>       // for boost::numeric_cast
 #include <boost/format.hpp>     // for boost::format
 
@@ -35,54 +37,227 @@
 #endif
 
 namespace checkpoint {
-    CheckPoint::CheckPoint()
-        : cfp(
-            reinterpret_cast<CheckPoint::CheckPointFastImpl *>(
-                FastArenaObject<sizeof(CheckPoint::CheckPointFastImpl)>::operator new(0)))
+    // #region staticメンバ変数
+
+    std::mutex CheckPoint::mtx;
+
+    std::atomic<std::uint64_t> CheckPoint::nextserial(1);
+
+    // #endregion staticメンバ変数
+
+    // #region コンストラクタ・デストラクタ
+
+    CheckPoint::CheckPoint(bool enabled)
+        : cfp(CheckPoint::allocate(enabled))
     {
     }
 
+    CheckPoint::CheckPointFastImpl::~CheckPointFastImpl()
+    {
+        for (auto tb = buffers.load(std::memory_order_acquire); tb;) {
+            for (auto c = tb->head; c;) {
+                auto const next = c->next;
+                CheckPoint::deallocatechunk(c);
+                c = next;
+            }
+
+            auto const next = tb->next;
+            delete tb;
+            tb = next;
+        }
+    }
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region publicメンバ関数
+
     void CheckPoint::checkpoint(char const * action, std::int32_t line)
     {
-        BOOST_ASSERT(cfp->cur < static_cast<std::int32_t>(CheckPoint::CheckPointFastImpl::N));
+        if (!cfp->enabled) {
+            return;
+        }
 
-        auto const p = cfp->points.begin() + cfp->cur;
+        auto const realtime = std::chrono::high_resolution_clock::now();
 
-        p->action = action;
-        p->line = line;
-        p->realtime = std::chrono::high_resolution_clock::now();
+        // 自分のスレッドの記録にだけ書き込むので、ロックは要らない
+        auto & tb = threadbuffer();
+        if (tb.tail->size == CheckPoint::Chunk::N) {
+            auto const c = CheckPoint::allocatechunk();
+            tb.tail->next = c;
+            tb.tail = c;
+        }
 
-        cfp->cur++;
+        auto & p = tb.tail->points[tb.tail->size++];
+        p.action = action;
+        p.line = line;
+        p.realtime = realtime;
     }
-    
+
     void CheckPoint::checkpoint_print() const
     {
         using namespace std::chrono;
 
-        std::optional<high_resolution_clock::time_point> prevreal(std::nullopt);
+        auto const records = merge();
+        auto const nthread = cfp->nthread.load(std::memory_order_acquire);
+        std::vector< std::optional<high_resolution_clock::time_point> > prevreal(nthread, std::nullopt);
+
+        for (auto const & [index, p] : records) {
+            if (prevreal[index]) {
+                auto const realtime(duration_cast< duration<double, std::milli> >(p.realtime - *prevreal[index]));
+                if (nthread > 1) {
+                    std::cout << boost::format("[thread %d] ") % index;
+                }
 
-        auto itr = cfp->points.begin();
-        for (auto i = 0; i < cfp->cur; ++i, ++itr) {
-            if (prevreal) {
-                auto const realtime(duration_cast< duration<double, std::milli> >(itr->realtime - *prevreal));
-                std::cout << itr->action
+                std::cout << p.action
                           << boost::format(" elapsed time = %.4f (msec)\n") % realtime.count();
             }
 
-            prevreal = std::make_optional(itr->realtime);
+            prevreal[index] = std::make_optional(p.realtime);
+        }
+    }
+
+    std::vector< std::pair<char const *, double> > CheckPoint::elapsed() const
+    {
+        using namespace std::chrono;
+
+        auto const records = merge();
+        std::vector< std::optional<high_resolution_clock::time_point> > prevreal(cfp->nthread.load(std::memory_order_acquire), std::nullopt);
+
+        std::vector< std::pair<char const *, double> > result;
+        for (auto const & [index, p] : records) {
+            if (prevreal[index]) {
+                auto const realtime(duration_cast< duration<double, std::milli> >(p.realtime - *prevreal[index]));
+                result.emplace_back(p.action, realtime.count());
+            }
+
+            prevreal[index] = std::make_optional(p.realtime);
         }
+
+        return result;
     }
 
     void CheckPoint::totalpassageoftime() const
     {
         using namespace std::chrono;
 
+        auto const records = merge();
+        if (records.empty()) {
+            return;
+        }
+
         auto const realtime = duration_cast< duration<double, std::milli> >(
-            cfp->points[cfp->cur - 1].realtime - cfp->points[0].realtime);
+            records.back().second.realtime - records.front().second.realtime);
 
         std::cout << boost::format("Total elapsed time = %.4f (msec)") % realtime.count() << std::endl;
     }
 
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    CheckPoint::CheckPointFastImpl * CheckPoint::allocate(bool enabled)
+    {
+        void * p;
+        {
+            std::lock_guard<std::mutex> lock(CheckPoint::mtx);
+            p = FastArenaObject<sizeof(CheckPoint::CheckPointFastImpl), CheckPoint::MAX_INSTANCES>::operator new(0);
+        }
+
+        if (!p) {
+            throw std::bad_alloc();
+        }
+
+        // 解放された領域は次の空き領域へのポインタで上書きされているので、必ず構築し直す
+        return new(p) CheckPoint::CheckPointFastImpl(enabled, CheckPoint::nextserial.fetch_add(1, std::memory_order_relaxed));
+    }
+
+    CheckPoint::Chunk * CheckPoint::allocatechunk()
+    {
+        void * p;
+        {
+            std::lock_guard<std::mutex> lock(CheckPoint::mtx);
+            p = FastArenaObject<sizeof(CheckPoint::Chunk), CheckPoint::MAX_CHUNKS>::operator new(0);
+        }
+
+        if (!p) {
+            // アリーナを使い切ったら、ヒープから確保して伸ばし続ける
+            auto const c = new CheckPoint::Chunk();
+            c->pooled = false;
+            return c;
+        }
+
+        return new(p) CheckPoint::Chunk();
+    }
+
+    void CheckPoint::deallocate(CheckPoint::CheckPointFastImpl * p)
+    {
+        std::lock_guard<std::mutex> lock(CheckPoint::mtx);
+        FastArenaObject<sizeof(CheckPoint::CheckPointFastImpl), CheckPoint::MAX_INSTANCES>::
+            operator delete(reinterpret_cast<void *>(p));
+    }
+
+    void CheckPoint::deallocatechunk(CheckPoint::Chunk * p)
+    {
+        if (!p->pooled) {
+            delete p;
+            return;
+        }
+
+        p->~Chunk();
+
+        std::lock_guard<std::mutex> lock(CheckPoint::mtx);
+        FastArenaObject<sizeof(CheckPoint::Chunk), CheckPoint::MAX_CHUNKS>::
+            operator delete(reinterpret_cast<void *>(p));
+    }
+
+    std::vector< std::pair<std::uint32_t, CheckPoint::Timestamp> > CheckPoint::merge() const
+    {
+        std::vector< std::pair<std::uint32_t, CheckPoint::Timestamp> > records;
+        for (auto tb = cfp->buffers.load(std::memory_order_acquire); tb; tb = tb->next) {
+            for (auto c = tb->head; c; c = c->next) {
+                for (auto i = 0U; i < c->size; i++) {
+                    records.emplace_back(tb->index, c->points[i]);
+                }
+            }
+        }
+
+        // 同じ時刻のチェックポイントは、同じスレッドの中の順序を保つ
+        std::stable_sort(records.begin(), records.end(), [](auto const & lhs, auto const & rhs) {
+            return lhs.second.realtime < rhs.second.realtime;
+        });
+
+        return records;
+    }
+
+    CheckPoint::ThreadBuffer & CheckPoint::threadbuffer()
+    {
+        // 直前に記録したオブジェクトの、このスレッドの記録（通し番号は1から始まるので、0は空を表す）
+        thread_local std::pair<std::uint64_t, CheckPoint::ThreadBuffer *> cache(0, nullptr);
+        if (cache.first == cfp->serial) {
+            return *cache.second;
+        }
+
+        auto const id = std::this_thread::get_id();
+        for (auto tb = cfp->buffers.load(std::memory_order_acquire); tb; tb = tb->next) {
+            if (tb->id == id) {
+                cache = std::make_pair(cfp->serial, tb);
+                return *tb;
+            }
+        }
+
+        // このスレッドの記録はまだないので作って、リストの先頭にロックなしでつなぐ
+        auto const c = CheckPoint::allocatechunk();
+        auto const tb = new CheckPoint::ThreadBuffer{ nullptr, id, cfp->nthread.fetch_add(1, std::memory_order_acq_rel), c, c };
+        tb->next = cfp->buffers.load(std::memory_order_relaxed);
+        while (!cfp->buffers.compare_exchange_weak(tb->next, tb, std::memory_order_release, std::memory_order_relaxed)) {
+        }
+
+        cache = std::make_pair(cfp->serial, tb);
+        return *tb;
+    }
+
+    // #endregion privateメンバ関数
+
     // #region 非メンバ関数
 
 #ifdef _WIN32
@@ -99,6 +274,21 @@ namespace checkpoint {
                   << "(kB)"
                   << std::endl; 
     }
+
+    std::size_t peakmem()
+    {
+        PROCESS_MEMORY_COUNTERS memInfo = { 0 };
+
+        if (!::GetProcessMemoryInfo(::GetCurrentProcess(), &memInfo, sizeof(memInfo))) {
+            throw std::system_error(std::error_code(::GetLastError(), std::system_category()));
+        }
+
+        return memInfo.PeakWorkingSetSize >> 10;
+    }
+
+    void resetpeakmem()
+    {
+    }
 #else
     void usedmem()
     {
@@ -113,6 +303,44 @@ namespace checkpoint {
                   << "(kB)"
                   << std::endl;
     }
+
+    std::size_t peakmem()
+    {
+#ifdef __linux__
+        // resetpeakmem()で戻せる値（VmHWM）を読む
+        if (auto const fp = std::fopen("/proc/self/status", "r")) {
+            char buf[256];
+            unsigned long kb = 0;
+            auto found = false;
+            while (!found && std::fgets(buf, sizeof(buf), fp)) {
+                found = std::sscanf(buf, "VmHWM: %lu kB", &kb) == 1;
+            }
+            std::fclose(fp);
+
+            if (found) {
+                return static_cast<std::size_t>(kb);
+            }
+        }
+#endif
+        struct rusage r;
+
+        if (getrusage(RUSAGE_SELF, &r)) {
+            throw std::system_error(errno, std::system_category());
+        }
+
+        return static_cast<std::size_t>(r.ru_maxrss);
+    }
+
+    void resetpeakmem()
+    {
+#ifdef __linux__
+        // "5"を書き込むと、VmHWMが今のメモリ使用量に戻る（Linux 4.0以降）
+        if (auto const fp = std::fopen("/proc/self/clear_refs", "w")) {
+            std::fputs("5", fp);
+            std::fclose(fp);
+        }
+#endif
+    }
 #endif
 
     // #endregion 非メンバ関数
@@ -23,15 +23,25 @@
 
 #include "fastarenaobject.h"
 #include <array>                // for std::array
+#include <atomic>               // for std::atomic
 #include <chrono>               // for std::chrono
-#include <cstdint>              // for std::int32_t, std::int64_t
+#include <cstdint>              // for std::int32_t, std::uint32_t, std::uint64_t
+#include <cstddef>              // for std::size_t
 #include <memory>               // for std::unique_ptr
+#include <mutex>                // for std::mutex
+#include <thread>               // for std::thread
 #include <utility>              // for std::pair
+#include <vector>               // for std::vector
 
 namespace checkpoint {
     //! A class.
     /*!
         時間計測のためのクラス
+        checkpoint()はどのスレッドから呼んでもよく、スレッドごとの記録にロックなしで書き込む
+        スレッドごとの記録は一定の数のチェックポイントの塊をつないだもので、塊はアリーナから確保して伸ばす
+        表示するときに、すべてのスレッドの記録を時刻の順に併合する
+        （表示と経過時間の取得は、checkpoint()を呼ぶスレッドがないときに行うこと）
+        無効にしたオブジェクトのcheckpoint()は、時刻も取らずにすぐ戻る
     */
     class CheckPoint final {
         // #region クラスの前方宣言
@@ -62,44 +72,133 @@ namespace checkpoint {
 
         //! A struct.
         /*!
-            チェックポイントの情報の配列を格納する構造体
+            一つのスレッドが記録するチェックポイントの塊
+        */
+        struct Chunk {
+            // #region メンバ変数
+
+            //! A public static member variable (constant).
+            /*!
+                一つの塊に入るチェックポイントの数
+            */
+            static auto constexpr N = 30U;
+
+            //! A public member variable.
+            /*!
+                同じスレッドの次の塊
+            */
+            Chunk * next = nullptr;
+
+            //! A public member variable.
+            /*!
+                この塊に記録したチェックポイントの数
+            */
+            std::uint32_t size = 0;
+
+            //! A public member variable.
+            /*!
+                アリーナから確保したかどうか（falseならヒープから確保した）
+            */
+            bool pooled = true;
+
+            //! A public member variable.
+            /*!
+                チェックポイントの情報の配列
+            */
+            std::array<CheckPoint::Timestamp, N> points;
+
+            // #endregion メンバ変数
+        };
+
+        //! A struct.
+        /*!
+            一つのスレッドのチェックポイントの記録
+        */
+        struct ThreadBuffer {
+            // #region メンバ変数
+
+            //! A public member variable.
+            /*!
+                同じオブジェクトの、次のスレッドの記録
+            */
+            ThreadBuffer * next;
+
+            //! A public member variable.
+            /*!
+                記録しているスレッドのID
+            */
+            std::thread::id id;
+
+            //! A public member variable.
+            /*!
+                スレッドの番号（最初に記録した順）
+            */
+            std::uint32_t index;
+
+            //! A public member variable.
+            /*!
+                最初の塊
+            */
+            Chunk * head;
+
+            //! A public member variable.
+            /*!
+                今書き込んでいる塊
+            */
+            Chunk * tail;
+
+            // #endregion メンバ変数
+        };
+
+        //! A struct.
+        /*!
+            スレッドごとのチェックポイントの記録を束ねる構造体
         */
         struct CheckPointFastImpl {
             // #region コンストラクタ・デストラクタ
 
-            //! A default constructor.
+            //! A constructor.
             /*!
-                デフォルトコンストラクタかつ唯一のコンストラクタ
+                唯一のコンストラクタ
+                \param enabled 記録するかどうか
+                \param serial オブジェクトの通し番号
             */
-            CheckPointFastImpl() : cur(0) {}
+            CheckPointFastImpl(bool enabled, std::uint64_t serial) : enabled(enabled), serial(serial) {}
 
-            //! A default destructor.
+            //! A destructor.
             /*!
-                デフォルトデストラクタ
+                デストラクタ
+                スレッドごとの記録と塊を解放する
             */
-            ~CheckPointFastImpl() = default;
+            ~CheckPointFastImpl();
 
             // #endregion コンストラクタ・デストラクタ
 
             // #region メンバ変数
 
-            //! A public static member variable (constant).
+            //! A public member variable (constant).
             /*!
-                チェックポイントの数
+                記録するかどうか
             */
-            static auto constexpr N = 30U;
+            bool const enabled;
 
             //! A public member variable.
             /*!
-                現在の場所
+                スレッドの数
+            */
+            std::atomic<std::uint32_t> nthread = 0;
+
+            //! A public member variable (constant).
+            /*!
+                オブジェクトの通し番号（スレッドごとの記録のキャッシュが、同じアドレスの別のオブジェクトを指さないように使う）
             */
-            std::int32_t cur;
+            std::uint64_t const serial;
 
             //! A public member variable.
             /*!
-                チェックポイントの情報の配列
+                スレッドごとの記録の連結リストの先頭
             */
-            std::array<CheckPoint::Timestamp, N> points;
+            std::atomic<ThreadBuffer *> buffers = nullptr;
 
             // #endregion メンバ変数
         };
@@ -108,11 +207,23 @@ namespace checkpoint {
 
         // #region クラス内クラスの宣言と実装
 
+        //! A private static member variable (constant expression).
+        /*!
+            同時に存在できるオブジェクトの数
+        */
+        static auto constexpr MAX_INSTANCES = 4U;
+
+        //! A private static member variable (constant expression).
+        /*!
+            アリーナに用意しておく塊の数（使い切ったらヒープから確保する）
+        */
+        static auto constexpr MAX_CHUNKS = 64U;
+
         template <typename T>
         struct fastpimpl_deleter {
             void operator()(T * p) const {
-                FastArenaObject<sizeof(CheckPointFastImpl)>::
-                    operator delete(reinterpret_cast<void *>(p));
+                p->~T();
+                CheckPoint::deallocate(p);
             }
         };
 
@@ -121,11 +232,12 @@ namespace checkpoint {
     public:
         // #region コンストラクタ・デストラクタ
 
-        //! A default constructor.
+        //! A constructor.
         /*!
-            デフォルトコンストラクタかつ唯一のコンストラクタ
+            唯一のコンストラクタ
+            \param enabled 記録するかどうか
         */
-        CheckPoint();
+        explicit CheckPoint(bool enabled = true);
 
         //! A default destructor.
         /*!
@@ -139,7 +251,7 @@ namespace checkpoint {
 
         //! A public member function.
         /*!
-            チェックポイントを設定する
+            チェックポイントを設定する（複数のスレッドから同時に呼んでもよい）
             \param line 行数
             \param action チェックポイントの名称
         */
@@ -147,10 +259,28 @@ namespace checkpoint {
 
         //! A public member function.
         /*!
-            直前のチェックポイントから計測した、経過時間を表示する
+            同じスレッドの直前のチェックポイントから計測した、経過時間を表示する
+            複数のスレッドで記録したときは、スレッドの番号も表示する
         */
         void checkpoint_print() const;
 
+        //! A public member function.
+        /*!
+            同じスレッドの直前のチェックポイントから計測した経過時間を、チェックポイントの名称との組で返す
+            \return チェックポイントの名称と経過時間（msec）の組の配列（各スレッドの最初のチェックポイントは含まない）
+        */
+        std::vector< std::pair<char const *, double> > elapsed() const;
+
+        //! A public member function (const).
+        /*!
+            記録するかどうかを返す
+            \return 記録するかどうか
+        */
+        bool enabled() const noexcept
+        {
+            return cfp->enabled;
+        }
+
         //! A public member function.
         /*!
             最初のチェックポイントから最後のチェックポイント
@@ -161,6 +291,53 @@ namespace checkpoint {
         // #endregion メンバ関数 
 
     private:
+        // #region privateメンバ関数
+
+        //! A private static member function.
+        /*!
+            アリーナからチェックポイントの記録を束ねる構造体の領域を確保して、構築する
+            \param enabled 記録するかどうか
+            \return 構築した構造体
+        */
+        static CheckPointFastImpl * allocate(bool enabled);
+
+        //! A private static member function.
+        /*!
+            塊を確保して、構築する（アリーナを使い切ったらヒープから確保する）
+            \return 構築した塊
+        */
+        static Chunk * allocatechunk();
+
+        //! A private static member function.
+        /*!
+            チェックポイントの記録を束ねる構造体の領域をアリーナに返す
+            \param p 解放する領域
+        */
+        static void deallocate(CheckPointFastImpl * p);
+
+        //! A private static member function.
+        /*!
+            塊を解放する
+            \param p 解放する塊
+        */
+        static void deallocatechunk(Chunk * p);
+
+        //! A private member function (const).
+        /*!
+            すべてのスレッドの記録を、時刻の順に併合する
+            \return スレッドの番号とチェックポイントの組の配列
+        */
+        std::vector< std::pair<std::uint32_t, Timestamp> > merge() const;
+
+        //! A private member function.
+        /*!
+            呼び出したスレッドの記録を返す（なければ作る）
+            \return 呼び出したスレッドの記録
+        */
+        ThreadBuffer & threadbuffer();
+
+        // #endregion privateメンバ関数
+
         // #region メンバ変数
 
         //! A private member variable (constant).
@@ -169,6 +346,18 @@ namespace checkpoint {
         */
         std::unique_ptr< CheckPointFastImpl, fastpimpl_deleter<CheckPointFastImpl> > const cfp;
 
+        //! A private static member variable.
+        /*!
+            アリーナから確保・解放するときのミューテックス
+        */
+        static std::mutex mtx;
+
+        //! A private static member variable.
+        /*!
+            次に構築するオブジェクトの通し番号
+        */
+        static std::atomic<std::uint64_t> nextserial;
+
         // #endregion メンバ変数
 
     public:
@@ -200,6 +389,20 @@ namespace checkpoint {
     */
     void usedmem();
 
+    //! A function.
+    /*!
+        自分自身のプロセスの最大メモリ使用量を返す
+        \return 最大メモリ使用量（kB）
+    */
+    std::size_t peakmem();
+
+    //! A function.
+    /*!
+        自分自身のプロセスの最大メモリ使用量を、今のメモリ使用量に戻す
+        （Linuxだけ。他のOSでは何もしないので、peakmem()はプロセス全体の最大値になる）
+    */
+    void resetpeakmem();
+
     // #endregion 非メンバ関数
 }
 
@@ -0,0 +1,112 @@
+﻿/*! \file perfcounters.cpp
+    \brief ハードウェアカウンタを読むクラスの実装
+    Copyright © 2014-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "perfcounters.h"
+#include <cstring>                  // for std::memset, std::strerror
+
+#ifdef __linux__
+    #include <errno.h>              // for errno
+    #include <linux/perf_event.h>   // for perf_event_attr, PERF_COUNT_HW_*, PERF_FORMAT_*
+    #include <sys/syscall.h>        // for SYS_perf_event_open
+    #include <unistd.h>             // for close, read, syscall
+#endif
+
+namespace checkpoint {
+    // #region コンストラクタ・デストラクタ
+
+#ifdef __linux__
+    PerfCounters::PerfCounters()
+    {
+        fd_.fill(-1);
+
+        static std::array<std::uint64_t, Event::NUM> constexpr CONFIG = {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        // グループにするとinheritと併用できないので、カウンタは一つずつ開く
+        for (auto i = 0U; i < Event::NUM; i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = CONFIG[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            fd_[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+            if (fd_[i] < 0) {
+                error_ = std::strerror(errno);
+                return;
+            }
+        }
+
+        available_ = true;
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+        for (auto const fd : fd_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+#else
+    PerfCounters::PerfCounters()
+        :   error_("perf_event_openはLinuxでしか使えません")
+    {
+        fd_.fill(-1);
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+    }
+#endif
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region publicメンバ関数
+
+    PerfCounters::value_type PerfCounters::read() const noexcept
+    {
+        value_type result = {};
+
+#ifdef __linux__
+        if (!available_) {
+            return result;
+        }
+
+        for (auto i = 0U; i < Event::NUM; i++) {
+            // 値、有効だった時間、実際に数えていた時間の順
+            std::array<std::uint64_t, 3> buf;
+            if (::read(fd_[i], buf.data(), sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)) || !buf[2]) {
+                continue;
+            }
+
+            result[i] = buf[1] == buf[2] ? buf[0] :
+                static_cast<std::uint64_t>(static_cast<double>(buf[0]) * static_cast<double>(buf[1]) / static_cast<double>(buf[2]));
+        }
+#endif
+
+        return result;
+    }
+
+    // #endregion publicメンバ関数
+}
@@ -0,0 +1,151 @@
+﻿/*! \file perfcounters.h
+    \brief ハードウェアカウンタを読むクラスの宣言
+    Copyright © 2014-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PERFCOUNTERS_H_
+#define _PERFCOUNTERS_H_
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint64_t
+#include <string>       // for std::string
+
+namespace checkpoint {
+    //! A class.
+    /*!
+        Linuxのperf_event_openで、ハードウェアカウンタ（サイクル数、命令数、キャッシュミス数、分岐予測ミス数）を読むクラス
+        カウンタはユーザー空間だけを数え、開いた後に生成されたスレッド（OpenMPのスレッドなど）の分も合計する
+        Linux以外や、権限がない・仮想マシンでPMUがないなどで開けないときは、available()がfalseを返す
+    */
+    class PerfCounters final {
+        // #region 型
+
+    public:
+        //! A enumeration.
+        /*!
+            カウンタの種類（value_typeの添字）
+        */
+        enum Event : std::size_t {
+            CYCLES,         //!< サイクル数
+            INSTRUCTIONS,   //!< 命令数
+            CACHE_MISSES,   //!< キャッシュミス数（最終レベルキャッシュ）
+            BRANCH_MISSES,  //!< 分岐予測ミス数
+            NUM             //!< カウンタの数
+        };
+
+        using value_type = std::array<std::uint64_t, Event::NUM>;
+
+        // #endregion 型
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A default constructor.
+        /*!
+            デフォルトコンストラクタ
+            カウンタを開いて、数え始める
+        */
+        PerfCounters();
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            カウンタを閉じる
+        */
+        ~PerfCounters();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (const).
+        /*!
+            カウンタが使えるかどうかを返す
+            \return カウンタが使えるかどうか
+        */
+        bool available() const noexcept
+        {
+            return available_;
+        }
+
+        //! A public member function (const).
+        /*!
+            カウンタが使えない理由を返す
+            \return カウンタが使えない理由（使えるときは空文字列）
+        */
+        std::string const & error() const noexcept
+        {
+            return error_;
+        }
+
+        //! A public member function (const).
+        /*!
+            カウンタを開いてからの累計値を読む
+            多重化されていたときは、実際に数えていた時間の割合で補正する
+            \return カウンタの累計値（使えないときはすべて0）
+        */
+        value_type read() const noexcept;
+
+        // #endregion publicメンバ関数
+
+        // #region メンバ変数
+
+    private:
+        //! A private member variable.
+        /*!
+            すべてのカウンタを開けたかどうか
+        */
+        bool available_ = false;
+
+        //! A private member variable.
+        /*!
+            カウンタが使えない理由
+        */
+        std::string error_;
+
+        //! A private member variable.
+        /*!
+            カウンタのファイル記述子
+        */
+        std::array<int, Event::NUM> fd_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        PerfCounters(PerfCounters const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        PerfCounters & operator=(PerfCounters const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _PERFCOUNTERS_H_
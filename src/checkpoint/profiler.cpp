@@ -0,0 +1,306 @@
+﻿/*! \file profiler.cpp
+    \brief 入れ子にできる区間ごとの時間計測と集計のためのクラスの実装
+    Copyright © 2014-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "profiler.h"
+#include <algorithm>            // for std::find_if, std::max, std::sort
+#include <cinttypes>            // for PRIu64
+#include <cmath>                // for std::ceil
+#include <cstdio>               // for FILE, std::fclose, std::fopen, std::fprintf
+#include <cstring>              // for std::strcmp
+#include <iostream>             // for std::cerr, std::cout
+#include <memory>               // for std::unique_ptr
+#include <numeric>              // for std::accumulate
+#include <stdexcept>            // for std::runtime_error
+#include <boost/assert.hpp>     // for BOOST_ASSERT
+#include <boost/format.hpp>     // for boost::format
+
+namespace checkpoint {
+    // #region コンストラクタ
+
+    Profiler::Profiler()
+        :   sections_(1)
+    {
+    }
+
+    ScopedTimer::ScopedTimer(char const * name)
+    {
+        auto & profiler = Profiler::instance();
+        if (profiler.enabled()) {
+            index_ = profiler.begin(name);
+            startcounters_ = lastcounters_ = profiler.counters();
+            start_ = last_ = std::chrono::high_resolution_clock::now();
+        }
+    }
+
+    ScopedTimer::~ScopedTimer()
+    {
+        if (index_) {
+            using namespace std::chrono;
+
+            auto const elapsed = duration_cast< duration<double, std::milli> >(high_resolution_clock::now() - start_);
+
+            auto & profiler = Profiler::instance();
+            profiler.record(*index_, elapsed.count(), ScopedTimer::difference(profiler.counters(), startcounters_));
+            profiler.end();
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    std::size_t Profiler::begin(char const * name)
+    {
+        auto const index = child(name);
+        Profiler::stack().push_back(index);
+
+        return index;
+    }
+
+    std::size_t Profiler::child(char const * name)
+    {
+        auto const parent = Profiler::stack().back();
+
+        // 区間の木は全スレッドで共有する（スレッドが違っても、同じ入れ子なら同じ区間に集計する）
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        // 子の数は少ないので、線形探索で十分
+        for (auto const & [childname, index] : sections_[parent].children) {
+            if (childname == name || !std::strcmp(childname, name)) {
+                return index;
+            }
+        }
+
+        auto const index = sections_.size();
+        Section section;
+        section.name = parent ? sections_[parent].name + "/" + name : std::string(name);
+        sections_.push_back(std::move(section));
+        sections_[parent].children.emplace_back(name, index);
+
+        return index;
+    }
+
+    void Profiler::end() noexcept
+    {
+        auto & stack = Profiler::stack();
+        BOOST_ASSERT(stack.size() > 1);
+
+        stack.pop_back();
+    }
+
+    Profiler & Profiler::instance()
+    {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    void Profiler::enable(bool usecounters)
+    {
+        enabled_ = true;
+
+        if (usecounters) {
+            pcounters_ = std::make_unique<PerfCounters>();
+            if (!pcounters_->available()) {
+                std::cerr << "ハードウェアカウンタが使えません（" << pcounters_->error() << "）。時間だけを計測します。" << std::endl;
+                pcounters_.reset();
+            }
+        }
+    }
+
+    void Profiler::print() const
+    {
+        std::cout << boost::format("%-40s %8s %12s %10s %10s %10s %10s %10s")
+            % "Section" % "Count" % "Total(ms)" % "Min" % "Mean" % "Max" % "P90" % "P99";
+        if (counting()) {
+            std::cout << boost::format(" %7s %10s %10s") % "IPC" % "Cache MPKI" % "Br MPKI";
+        }
+        std::cout << '\n';
+
+        for (auto const & s : summarize()) {
+            std::cout << boost::format("%-40s %8d %12.3f %10.4f %10.4f %10.4f %10.4f %10.4f")
+                % s.name % s.count % s.total % s.min % s.mean % s.max % s.p90 % s.p99;
+
+            if (counting()) {
+                // IPCが低くキャッシュミスが多ければメモリ律速、IPCが高ければ演算律速
+                auto const cycles = static_cast<double>(s.counters[PerfCounters::CYCLES]);
+                auto const instructions = static_cast<double>(s.counters[PerfCounters::INSTRUCTIONS]);
+                auto const perkilo = instructions > 0.0 ? 1000.0 / instructions : 0.0;
+                std::cout << boost::format(" %7.3f %10.4f %10.4f")
+                    % (cycles > 0.0 ? instructions / cycles : 0.0)
+                    % (static_cast<double>(s.counters[PerfCounters::CACHE_MISSES]) * perkilo)
+                    % (static_cast<double>(s.counters[PerfCounters::BRANCH_MISSES]) * perkilo);
+            }
+            std::cout << '\n';
+        }
+    }
+
+    void Profiler::record(std::size_t index, double msec, PerfCounters::value_type const & counters)
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+
+        auto & section = sections_[index];
+        section.samples.push_back(msec);
+
+        for (auto i = 0U; i < counters.size(); i++) {
+            section.counters[i] += counters[i];
+        }
+    }
+
+    void Profiler::save(std::string const & filename) const
+    {
+        auto const json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+        if (json) {
+            savejson(filename);
+        }
+        else {
+            savecsv(filename);
+        }
+    }
+
+    std::vector<Profiler::Summary> Profiler::summarize() const
+    {
+        std::vector<Summary> result;
+        for (auto const & section : sections_) {
+            if (section.samples.empty()) {
+                continue;
+            }
+
+            auto sorted(section.samples);
+            std::sort(sorted.begin(), sorted.end());
+
+            // 最近順位法（p%の値は、小さい方からceil(p / 100 * n)番目）
+            auto const n = sorted.size();
+            auto const percentile = [&sorted, n](double p) {
+                auto const rank = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(n)));
+                return sorted[std::max<std::size_t>(rank, 1) - 1];
+            };
+
+            auto const total = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+            result.push_back({ section.name, n, total, sorted.front(), total / static_cast<double>(n), sorted.back(),
+                               percentile(50.0), percentile(90.0), percentile(99.0), section.counters });
+        }
+
+        return result;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    void Profiler::savecsv(std::string const & filename) const
+    {
+        std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(filename.c_str(), "w"), std::fclose);
+        if (!fp) {
+            throw std::runtime_error("ファイルが開けませんでした。");
+        }
+
+        // ハードウェアカウンタの列は、数えているときだけ書き込む
+        std::fprintf(fp.get(), "name,count,total_ms,min_ms,mean_ms,max_ms,p50_ms,p90_ms,p99_ms%s\n",
+            counting() ? ",cycles,instructions,cache_misses,branch_misses" : "");
+        for (auto const & s : summarize()) {
+            std::fprintf(fp.get(), "%s,%zu,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f",
+                s.name.c_str(), s.count, s.total, s.min, s.mean, s.max, s.p50, s.p90, s.p99);
+            if (counting()) {
+                std::fprintf(fp.get(), ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64,
+                    s.counters[PerfCounters::CYCLES], s.counters[PerfCounters::INSTRUCTIONS],
+                    s.counters[PerfCounters::CACHE_MISSES], s.counters[PerfCounters::BRANCH_MISSES]);
+            }
+            std::fprintf(fp.get(), "\n");
+        }
+    }
+
+    void Profiler::savejson(std::string const & filename) const
+    {
+        std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(filename.c_str(), "w"), std::fclose);
+        if (!fp) {
+            throw std::runtime_error("ファイルが開けませんでした。");
+        }
+
+        // 区間の名前は文字列リテラルなので、エスケープは要らない
+        std::fprintf(fp.get(), "{\n  \"sections\": [");
+
+        auto first = true;
+        for (auto const & s : summarize()) {
+            std::fprintf(fp.get(), "%s\n    {\"name\": \"%s\", \"count\": %zu, \"total_ms\": %.6f, \"min_ms\": %.6f, "
+                "\"mean_ms\": %.6f, \"max_ms\": %.6f, \"p50_ms\": %.6f, \"p90_ms\": %.6f, \"p99_ms\": %.6f, \"samples_ms\": [",
+                first ? "" : ",", s.name.c_str(), s.count, s.total, s.min, s.mean, s.max, s.p50, s.p90, s.p99);
+            first = false;
+
+            auto const itr = std::find_if(sections_.begin(), sections_.end(), [&s](auto const & section) { return section.name == s.name; });
+            for (auto i = 0U; i < itr->samples.size(); i++) {
+                std::fprintf(fp.get(), i ? ", %.6f" : "%.6f", itr->samples[i]);
+            }
+            std::fprintf(fp.get(), "]");
+
+            if (counting()) {
+                std::fprintf(fp.get(), ", \"cycles\": %" PRIu64 ", \"instructions\": %" PRIu64 ", \"cache_misses\": %" PRIu64 ", \"branch_misses\": %" PRIu64,
+                    s.counters[PerfCounters::CYCLES], s.counters[PerfCounters::INSTRUCTIONS],
+                    s.counters[PerfCounters::CACHE_MISSES], s.counters[PerfCounters::BRANCH_MISSES]);
+            }
+            std::fprintf(fp.get(), "}");
+        }
+
+        std::fprintf(fp.get(), "\n  ]\n}\n");
+    }
+
+    std::vector<std::size_t> & Profiler::stack()
+    {
+        // スレッドごとに根から始める（OpenMPのタスクの中で計測しても、入れ子が混ざらない）
+        thread_local std::vector<std::size_t> stack(1, 0);
+        return stack;
+    }
+
+    // #endregion privateメンバ関数
+
+    // #region publicメンバ関数
+
+    void ScopedTimer::split(char const * name)
+    {
+        if (!index_) {
+            return;
+        }
+
+        using namespace std::chrono;
+
+        auto const now = high_resolution_clock::now();
+        auto const elapsed = duration_cast< duration<double, std::milli> >(now - last_);
+        last_ = now;
+
+        auto & profiler = Profiler::instance();
+        auto const counters = profiler.counters();
+        profiler.record(profiler.child(name), elapsed.count(), ScopedTimer::difference(counters, lastcounters_));
+        lastcounters_ = counters;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    PerfCounters::value_type ScopedTimer::difference(PerfCounters::value_type const & now, PerfCounters::value_type const & before) noexcept
+    {
+        PerfCounters::value_type result;
+        for (auto i = 0U; i < result.size(); i++) {
+            // 多重化の補正で累計値がわずかに減ることがあるので、負にならないようにする
+            result[i] = now[i] > before[i] ? now[i] - before[i] : 0;
+        }
+
+        return result;
+    }
+
+    // #endregion privateメンバ関数
+}
@@ -0,0 +1,384 @@
+﻿/*! \file profiler.h
+    \brief 入れ子にできる区間ごとの時間計測と集計のためのクラスの宣言
+    Copyright © 2014-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#pragma once
+
+#include "perfcounters.h"
+#include <chrono>       // for std::chrono
+#include <cstddef>      // for std::size_t
+#include <memory>       // for std::unique_ptr
+#include <mutex>        // for std::mutex
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <utility>      // for std::pair
+#include <vector>       // for std::vector
+
+namespace checkpoint {
+    //! A class.
+    /*!
+        名前の付いた区間ごとに経過時間を記録し、集計して出力するクラス
+        区間は入れ子にでき、「親/子」の名前で集計する
+        有効にしたときだけ記録する（無効なときのScopedTimerは時刻も取らない）
+        開いている区間のスタックはスレッドごとに持つので、複数のスレッドから使ってよい
+        （区間の作成と記録はミューテックスで守る。表示と書き込みは、計測するスレッドがないときに行うこと）
+    */
+    class Profiler final {
+        // #region 型
+
+    public:
+        //! A struct.
+        /*!
+            一つの区間の集計結果
+        */
+        struct Summary final {
+            std::string name;       //!< 区間の名前（「親/子」）
+            std::size_t count;      //!< 計測した回数
+            double total;           //!< 合計（msec）
+            double min;             //!< 最小値（msec）
+            double mean;            //!< 平均値（msec）
+            double max;             //!< 最大値（msec）
+            double p50;             //!< 50パーセンタイル（msec）
+            double p90;             //!< 90パーセンタイル（msec）
+            double p99;             //!< 99パーセンタイル（msec）
+            PerfCounters::value_type counters;  //!< ハードウェアカウンタの合計
+        };
+
+        // #endregion 型
+
+        // #region コンストラクタ・デストラクタ
+
+    private:
+        //! A default constructor.
+        /*!
+            デフォルトコンストラクタ（instance()からだけ呼ぶ）
+        */
+        Profiler();
+
+    public:
+        //! A default destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~Profiler() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function.
+        /*!
+            区間を開始する（今開いている区間の子になる）
+            \param name 区間の名前（文字列リテラル）
+            \return 区間の番号
+        */
+        std::size_t begin(char const * name);
+
+        //! A public member function.
+        /*!
+            今開いている区間の子の区間の番号を返す（なければ作る）
+            \param name 子の区間の名前（文字列リテラル）
+            \return 区間の番号
+        */
+        std::size_t child(char const * name);
+
+        //! A public member function (const).
+        /*!
+            ハードウェアカウンタの累計値を読む
+            \return ハードウェアカウンタの累計値（数えていないときはすべて0）
+        */
+        PerfCounters::value_type counters() const noexcept
+        {
+            return pcounters_ ? pcounters_->read() : PerfCounters::value_type();
+        }
+
+        //! A public member function (const).
+        /*!
+            ハードウェアカウンタを数えているかどうかを返す
+            \return ハードウェアカウンタを数えているかどうか
+        */
+        bool counting() const noexcept
+        {
+            return static_cast<bool>(pcounters_);
+        }
+
+        //! A public member function.
+        /*!
+            区間の経過時間とハードウェアカウンタの増分を記録する
+            \param index 区間の番号
+            \param msec 経過時間（msec）
+            \param counters ハードウェアカウンタの増分
+        */
+        void record(std::size_t index, double msec, PerfCounters::value_type const & counters);
+
+        //! A public member function.
+        /*!
+            今開いている区間を閉じる
+        */
+        void end() noexcept;
+
+        //! A public member function.
+        /*!
+            記録を有効にする
+            ハードウェアカウンタが使えないときは、理由を表示して時間だけを計測する
+            \param usecounters ハードウェアカウンタも数えるかどうか
+        */
+        void enable(bool usecounters);
+
+        //! A public member function (const).
+        /*!
+            記録が有効かどうかを返す
+            \return 記録が有効かどうか
+        */
+        bool enabled() const noexcept
+        {
+            return enabled_;
+        }
+
+        //! A public static member function.
+        /*!
+            プロセスに一つのオブジェクトを返す
+            \return プロセスに一つのオブジェクト
+        */
+        static Profiler & instance();
+
+        //! A public member function (const).
+        /*!
+            集計結果を表として表示する
+            ハードウェアカウンタを数えているときは、IPCと千命令あたりのキャッシュミス数・分岐予測ミス数も表示する
+        */
+        void print() const;
+
+        //! A public member function (const).
+        /*!
+            集計結果をファイルに書き込む（拡張子が.jsonならJSON形式で各回の値も含め、それ以外はCSV形式）
+            \param filename ファイル名
+        */
+        void save(std::string const & filename) const;
+
+        //! A public member function (const).
+        /*!
+            記録した区間を集計する
+            \return 区間ごとの集計結果（区間を最初に開始した順）
+        */
+        std::vector<Summary> summarize() const;
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private member function (const).
+        /*!
+            集計結果をCSV形式で書き込む
+            \param filename ファイル名
+        */
+        void savecsv(std::string const & filename) const;
+
+        //! A private member function (const).
+        /*!
+            集計結果と各回の値をJSON形式で書き込む
+            \param filename ファイル名
+        */
+        void savejson(std::string const & filename) const;
+
+        //! A private static member function.
+        /*!
+            呼び出したスレッドの、開いている区間の番号のスタックを返す（一番下は根）
+            \return 呼び出したスレッドのスタック
+        */
+        static std::vector<std::size_t> & stack();
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A struct.
+        /*!
+            一つの区間の記録
+        */
+        struct Section final {
+            std::string name;                                           //!< 区間の名前（「親/子」）
+            std::vector< std::pair<char const *, std::size_t> > children;   //!< 子の区間の名前と番号
+            std::vector<double> samples;                                //!< 各回の経過時間（msec）
+            PerfCounters::value_type counters = {};                     //!< ハードウェアカウンタの増分の合計
+        };
+
+        //! A private member variable.
+        /*!
+            記録が有効かどうか
+        */
+        bool enabled_ = false;
+
+        //! A private member variable.
+        /*!
+            ハードウェアカウンタ（数えないときはnullptr）
+        */
+        std::unique_ptr<PerfCounters> pcounters_;
+
+        //! A private member variable.
+        /*!
+            区間の記録を守るミューテックス
+        */
+        std::mutex mtx_;
+
+        //! A private member variable.
+        /*!
+            区間の記録（0番目は名前のない根）
+        */
+        std::vector<Section> sections_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        Profiler(Profiler const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        Profiler & operator=(Profiler const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+
+    //! A class.
+    /*!
+        生存期間を一つの区間として計測するクラス
+        split()を呼ぶと、前回のsplit()（最初はコンストラクタ）からの時間を子の区間として記録する
+        Profilerが無効なときは何もしない
+    */
+    class ScopedTimer final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param name 区間の名前（文字列リテラル）
+        */
+        explicit ScopedTimer(char const * name);
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            区間の経過時間を記録して、区間を閉じる
+        */
+        ~ScopedTimer();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function.
+        /*!
+            前回のsplit()からの時間を、子の区間として記録する
+            \param name 子の区間の名前（文字列リテラル）
+        */
+        void split(char const * name);
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private static member function.
+        /*!
+            ハードウェアカウンタの増分を求める
+            \param now 今の累計値
+            \param before 前の累計値
+            \return 増分
+        */
+        static PerfCounters::value_type difference(PerfCounters::value_type const & now, PerfCounters::value_type const & before) noexcept;
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            区間の番号（Profilerが無効なときはstd::nullopt）
+        */
+        std::optional<std::size_t> index_;
+
+        //! A private member variable.
+        /*!
+            前回のsplit()の時刻
+        */
+        std::chrono::high_resolution_clock::time_point last_;
+
+        //! A private member variable.
+        /*!
+            前回のsplit()のときのハードウェアカウンタの累計値
+        */
+        PerfCounters::value_type lastcounters_;
+
+        //! A private member variable.
+        /*!
+            区間を開始した時刻
+        */
+        std::chrono::high_resolution_clock::time_point start_;
+
+        //! A private member variable.
+        /*!
+            区間を開始したときのハードウェアカウンタの累計値
+        */
+        PerfCounters::value_type startcounters_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ScopedTimer() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        ScopedTimer(ScopedTimer const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        ScopedTimer & operator=(ScopedTimer const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _PROFILER_H_
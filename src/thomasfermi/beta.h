@@ -62,6 +62,16 @@ namespace thomasfermi {
             */
             double operator()(double x) const;
 
+            template <Element E>
+            //! A public member function (const).
+            /*!
+                xを含む区間がわかっているときに、二分探索を省略してβ(x)を計算して返す
+                \param klo xを含む区間の左端の節点の番号
+                \param x xの値
+                \return β(x)の値
+            */
+            double operator()(std::size_t klo, double x) const;
+
             template <Element E>
             //! A public member function (const).
             /*!
@@ -159,6 +169,15 @@ namespace thomasfermi {
             return (yvec_[khi] - yvec_[klo]) / (xvec_[khi] - xvec_[klo]) * (x - xvec_[klo]) + yvec_[klo];
         }
 
+        template <>
+        inline double Beta::operator()<Element::First>(std::size_t klo, double x) const
+        {
+            auto const khi = klo + 1;
+
+            // yvec_[i] = f(xvec_[i]), yvec_[i + 1] = f(xvec_[i + 1])の二点を通る直線を代入
+            return (yvec_[khi] - yvec_[klo]) / (xvec_[khi] - xvec_[klo]) * (x - xvec_[klo]) + yvec_[klo];
+        }
+
         template <>
         inline double Beta::operator()<Element::Second>(double x) const
         {
@@ -23,6 +23,7 @@
 
 #include "ci_string.h"
 #include <cstdint>      // for std::uint32_t, std::uint8_t
+#include <vector>       // for std::vector
 
 namespace thomasfermi {
     //! A global variable (constant expression).
@@ -73,6 +74,12 @@ namespace thomasfermi {
     */
     static auto constexpr ITERATION_MIXING_WEIGHT_DEFAULT = 0.08;
 
+    //! A global variable (constant expression).
+    /*!
+        λWeizsäcker補正の係数λのデフォルト値
+    */
+    static auto constexpr WEIZSACKER_LAMBDA_DEFAULT = 1.0 / 9.0;
+
     //! A global variable (constant expression).
     /*!
         微分方程式を解くときのメッシュの最大値のデフォルト値
@@ -85,6 +92,16 @@ namespace thomasfermi {
     */
     static auto constexpr XMIN_DEFAULT = 1.0E-5;
 
+    //! A enumeration.
+    /*!
+        解く模型
+    */
+    enum class Model : std::uint8_t {
+        TF,     //!< Thomas-Fermi模型
+        TFD,    //!< Thomas-Fermi-Dirac模型（交換項を含む）
+        TFW     //!< Thomas-Fermi-λWeizsäcker模型（勾配補正を含む）
+    };
+
     //! A struct.
     /*!
         インプットファイルの各種データの構造体
@@ -92,6 +109,24 @@ namespace thomasfermi {
     struct Data final {
         // #region メンバ変数
 
+        //!  A public member variable.
+        /*!
+            原子量（セルの半径を質量密度から求めるのに使う）
+        */
+        double atomic_mass_ = 0.0;
+
+        //!  A public member variable.
+        /*!
+            セル（Wigner-Seitzセル）の質量密度（g/cm^3）のリスト（空ならセルに閉じ込めない）
+        */
+        std::vector<double> cell_density_;
+
+        //!  A public member variable.
+        /*!
+            反復の状態をチェックポイントファイルに書き出す間隔（反復回数、0なら書き出さない）
+        */
+        std::uint32_t checkpoint_interval_ = 0;
+
         //!  A public member variable.
         /*!
             微分方程式を解くときの許容誤差
@@ -140,6 +175,66 @@ namespace thomasfermi {
         */
         double iteration_mixing_weight_ = ITERATION_MIXING_WEIGHT_DEFAULT;
 
+        //!  A public member variable.
+        /*!
+            イオンの電離度q = (Z - N) / Zのリスト（空なら中性原子）
+        */
+        std::vector<double> ion_degree_;
+
+        //!  A public member variable.
+        /*!
+            解く模型
+        */
+        Model model_ = Model::TF;
+
+        //!  A public member variable.
+        /*!
+            計算結果をCSVファイルに加えてバイナリファイルにも出力するかどうか
+        */
+        bool output_binary_ = false;
+
+        //!  A public member variable.
+        /*!
+            CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
+        */
+        double output_tolerance_ = 0.0;
+
+        //!  A public member variable.
+        /*!
+            チェックポイントファイルから反復を再開するかどうか（コマンドラインオプションで指定する）
+        */
+        bool restart_ = false;
+
+        //!  A public member variable.
+        /*!
+            パラメータスイープするメッシュの数のリスト（空ならパラメータスイープしない）
+        */
+        std::vector<double> sweep_grid_num_;
+
+        //!  A public member variable.
+        /*!
+            パラメータスイープするマッチングポイントのリスト
+        */
+        std::vector<double> sweep_match_point_;
+
+        //!  A public member variable.
+        /*!
+            パラメータスイープする電子密度を合成するときの重みのリスト
+        */
+        std::vector<double> sweep_mixing_weight_;
+
+        //!  A public member variable.
+        /*!
+            パラメータスイープするメッシュの最大値のリスト
+        */
+        std::vector<double> sweep_xmax_;
+
+        //!  A public member variable.
+        /*!
+            温度（eV）のリスト（空なら絶対零度）
+        */
+        std::vector<double> temperature_;
+
         //!  A public member variable.
         /*!
             OpenMPを使用するかどうか
@@ -152,6 +247,12 @@ namespace thomasfermi {
         */
         double xmax_ = XMAX_DEFAULT;
 
+        //!  A public member variable.
+        /*!
+            λWeizsäcker補正の係数λ
+        */
+        double weizsacker_lambda_ = WEIZSACKER_LAMBDA_DEFAULT;
+
         //!  A public member variable.
         /*!
             微分方程式を解くときのメッシュの最小値
@@ -164,6 +265,12 @@ namespace thomasfermi {
         */
         double Z_;
 
+        //!  A public member variable.
+        /*!
+            原子核の電荷のリスト（二つ以上ならバッチモード）
+        */
+        std::vector<double> Zlist_;
+
         // #endregion メンバ変数
     };
 }
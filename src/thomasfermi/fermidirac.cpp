@@ -0,0 +1,149 @@
+﻿/*! \file fermidirac.cpp
+    \brief 完全Fermi-Dirac積分F_{1/2}(η)を補間表で高速に評価するクラスの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fermidirac.h"
+#include "gausslegendre/gausslegendre.h"
+#include <algorithm>                      // for std::clamp, std::max, std::min
+#include <cmath>                          // for std::ceil, std::exp, std::sqrt
+
+namespace fermidirac {
+    // #region コンストラクタ
+
+    FermiDirac::FermiDirac()
+    {
+        auto const nint = static_cast<std::size_t>((FermiDirac::ETA_MAX - FermiDirac::ETA_MIN) * FermiDirac::DIVISION);
+        auto const h = 1.0 / FermiDirac::DIVISION;
+
+        // 節点での値と導関数（F_{3/2}の導関数は、dF_{3/2}/dη = (3/2)F_{1/2}から求める）
+        std::vector< std::array<double, 3> > node(nint + 1);
+        std::vector< std::array<double, 3> > node32(nint + 1);
+        for (auto i = 0U; i <= nint; i++) {
+            auto const [f, df, ddf, f32] = FermiDirac::integral(FermiDirac::ETA_MIN + static_cast<double>(i) * h);
+            node[i] = { f, df, ddf };
+            node32[i] = { f32, 1.5 * f, 1.5 * df };
+        }
+
+        coef_.resize(nint);
+        coef32_.resize(nint);
+        for (auto i = 0U; i < nint; i++) {
+            coef_[i] = FermiDirac::hermite(node[i], node[i + 1], h);
+            coef32_[i] = FermiDirac::hermite(node32[i], node32[i + 1], h);
+        }
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    void FermiDirac::operator()(double const * eta, double * f, std::size_t n) const noexcept
+    {
+        auto const * const c = coef_.data();
+        auto const last = coef_.size() - 1;
+        auto const xmax = static_cast<double>(coef_.size());
+
+        // 表の範囲外の要素も、いったん端の区間の多項式で計算しておく（分岐のないループにするため）
+#if _OPENMP >= 201307
+    #pragma omp simd
+#endif
+        for (auto i = 0U; i < n; i++) {
+            auto const x = std::clamp((eta[i] - FermiDirac::ETA_MIN) * FermiDirac::DIVISION, 0.0, xmax);
+            auto const j = std::min(static_cast<std::size_t>(x), last);
+            auto const s = x - static_cast<double>(j);
+
+            auto const & cj(c[j]);
+            f[i] = cj[0] + s * (cj[1] + s * (cj[2] + s * (cj[3] + s * (cj[4] + s * cj[5]))));
+        }
+
+        // 表の範囲外の要素は漸近展開で置き換える
+        for (auto i = 0U; i < n; i++) {
+            if (eta[i] < FermiDirac::ETA_MIN || eta[i] > FermiDirac::ETA_MAX) {
+                f[i] = (*this)(eta[i]);
+            }
+        }
+    }
+
+    FermiDirac const & FermiDirac::Instance()
+    {
+        static FermiDirac const fd;
+        return fd;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    FermiDirac::coefficient_type FermiDirac::hermite(std::array<double, 3> const & f0, std::array<double, 3> const & f1, double h) noexcept
+    {
+        // 区間内の位置s∈[0, 1]の5次多項式p(s)について、両端でp、dp/ds = hf'、d^2p/ds^2 = h^2f''を一致させる
+        coefficient_type c;
+        c[0] = f0[0];
+        c[1] = h * f0[1];
+        c[2] = 0.5 * h * h * f0[2];
+
+        auto const d0 = f1[0] - (c[0] + c[1] + c[2]);
+        auto const d1 = h * f1[1] - (c[1] + 2.0 * c[2]);
+        auto const d2 = h * h * f1[2] - 2.0 * c[2];
+
+        c[3] = 10.0 * d0 - 4.0 * d1 + 0.5 * d2;
+        c[4] = -15.0 * d0 + 7.0 * d1 - d2;
+        c[5] = 6.0 * d0 - 3.0 * d1 + 0.5 * d2;
+
+        return c;
+    }
+
+    std::array<double, 4> FermiDirac::integral(double eta)
+    {
+        static gausslegendre::Gauss_Legendre const gl(FermiDirac::QUADRATURE_NUM);
+        auto const & x(gl.X());
+        auto const & w(gl.W());
+
+        // t = s^2とすると、F_{1/2}(η) = ∫(0～∞)2s^2σds（σ = 1 / (1 + exp(s^2 - η))）
+        // 導関数はdσ/dη = σ(1 - σ)、d^2σ/dη^2 = σ(1 - σ)(1 - 2σ)から求める
+        // F_{3/2}(η) = ∫(0～∞)2s^4σds
+        // exp(s^2 - η) < exp(-50)となるところで積分を打ち切る
+        auto const smax = std::sqrt(std::max(eta, 0.0) + 50.0);
+        auto const npanel = static_cast<std::size_t>(std::ceil(smax / FermiDirac::QUADRATURE_WIDTH));
+        auto const width = smax / static_cast<double>(npanel);
+
+        std::array<double, 4> sum = { 0.0, 0.0, 0.0, 0.0 };
+        for (auto i = 0U; i < npanel; i++) {
+            auto const sm = (static_cast<double>(i) + 0.5) * width;
+            auto const sr = 0.5 * width;
+
+            for (auto j = 0U; j < x.size(); j++) {
+                auto const s = sm + sr * x[j];
+                auto const e = std::exp(s * s - eta);
+
+                // σ、σ(1 - σ)、σ(1 - σ)(1 - 2σ)を桁落ちしないように計算する
+                auto const sigma = 1.0 / (1.0 + e);
+                auto const dsigma = e * sigma * sigma;
+                auto const ddsigma = dsigma * (e - 1.0) * sigma;
+
+                auto const ws = 2.0 * sr * w[j] * s * s;
+                sum[0] += ws * sigma;
+                sum[1] += ws * dsigma;
+                sum[2] += ws * ddsigma;
+                sum[3] += ws * s * s * sigma;
+            }
+        }
+
+        return sum;
+    }
+
+    // #endregion privateメンバ関数
+}
@@ -0,0 +1,243 @@
+﻿/*! \file fermidirac.h
+    \brief 完全Fermi-Dirac積分F_{1/2}(η)を補間表で高速に評価するクラスの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _FERMIDIRAC_H_
+#define _FERMIDIRAC_H_
+
+#pragma once
+
+#include <algorithm>                            // for std::min
+#include <array>                                // for std::array
+#include <cmath>                                // for std::exp, std::sqrt
+#include <cstddef>                              // for std::size_t
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace fermidirac {
+    //! A class.
+    /*!
+        完全Fermi-Dirac積分F_{1/2}(η) = ∫(0～∞)t^(1/2) / (1 + exp(t - η))dtを評価するクラス
+        η∈[ETA_MIN, ETA_MAX]では、等間隔の表の各区間で値と1階・2階の導関数が一致する
+        5次のHermite多項式の係数を持っておき、Horner法で評価する
+        表の外側では漸近展開（η → -∞では級数、η → ∞ではSommerfeld展開）を用いる
+        圧力と運動エネルギーに使うF_{3/2}(η)も、dF_{3/2}/dη = (3/2)F_{1/2}を使って同じように表にしておく
+    */
+    class FermiDirac final {
+        // #region 型エイリアス
+
+        using coefficient_type = std::array<double, 6>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            表の節点でF_{1/2}とその導関数を数値積分で求め、補間多項式の係数を生成する
+        */
+        FermiDirac();
+
+        //! A default destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~FermiDirac() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (const).
+        /*!
+            F_{1/2}(η)の値を返す
+            \param eta η
+            \return F_{1/2}(η)
+        */
+        double operator()(double eta) const noexcept
+        {
+            if (eta < FermiDirac::ETA_MIN) {
+                // F_{1/2}(η) = Γ(3/2)[exp(η) - exp(2η) / 2^(3/2) + ...]
+                auto const e = std::exp(eta);
+                return FermiDirac::GAMMA_3_2 * e * (1.0 - e / (2.0 * boost::math::constants::root_two<double>()));
+            }
+            else if (eta > FermiDirac::ETA_MAX) {
+                // F_{1/2}(η) = (2/3)η^(3/2)[1 + (π^2 / 8)η^(-2) + (7π^4 / 640)η^(-4) + (31π^6 / 3072)η^(-6) + ...]
+                auto const pi2 = boost::math::constants::pi_sqr<double>();
+                auto const r = 1.0 / (eta * eta);
+                return 2.0 / 3.0 * eta * std::sqrt(eta) *
+                    (1.0 + r * pi2 * (1.0 / 8.0 + r * pi2 * (7.0 / 640.0 + r * pi2 * 31.0 / 3072.0)));
+            }
+
+            // 区間の番号と、区間内の位置s∈[0, 1]
+            auto const x = (eta - FermiDirac::ETA_MIN) * FermiDirac::DIVISION;
+            auto const i = std::min(static_cast<std::size_t>(x), coef_.size() - 1);
+            auto const s = x - static_cast<double>(i);
+
+            auto const & c(coef_[i]);
+            return c[0] + s * (c[1] + s * (c[2] + s * (c[3] + s * (c[4] + s * c[5]))));
+        }
+
+        //! A public member function (const).
+        /*!
+            n個のηについて、まとめてF_{1/2}(η)の値を求める
+            ループはSIMD化されるように書いてある
+            \param eta ηの配列
+            \param f F_{1/2}(η)を格納する配列
+            \param n 配列の要素数
+        */
+        void operator()(double const * eta, double * f, std::size_t n) const noexcept;
+
+        //! A public member function (const).
+        /*!
+            F_{3/2}(η) = ∫(0～∞)t^(3/2) / (1 + exp(t - η))dtの値を返す
+            \param eta η
+            \return F_{3/2}(η)
+        */
+        double threehalves(double eta) const noexcept
+        {
+            if (eta < FermiDirac::ETA_MIN) {
+                // F_{3/2}(η) = Γ(5/2)[exp(η) - exp(2η) / 2^(5/2) + ...]
+                auto const e = std::exp(eta);
+                return 1.5 * FermiDirac::GAMMA_3_2 * e * (1.0 - e / (4.0 * boost::math::constants::root_two<double>()));
+            }
+            else if (eta > FermiDirac::ETA_MAX) {
+                // F_{3/2}(η) = (2/5)η^(5/2)[1 + (5π^2 / 8)η^(-2) - (7π^4 / 384)η^(-4) - (155π^6 / 21504)η^(-6) + ...]
+                auto const pi2 = boost::math::constants::pi_sqr<double>();
+                auto const r = 1.0 / (eta * eta);
+                return 0.4 * eta * eta * std::sqrt(eta) *
+                    (1.0 + r * pi2 * (5.0 / 8.0 - r * pi2 * (7.0 / 384.0 + r * pi2 * 155.0 / 21504.0)));
+            }
+
+            auto const x = (eta - FermiDirac::ETA_MIN) * FermiDirac::DIVISION;
+            auto const i = std::min(static_cast<std::size_t>(x), coef32_.size() - 1);
+            auto const s = x - static_cast<double>(i);
+
+            auto const & c(coef32_[i]);
+            return c[0] + s * (c[1] + s * (c[2] + s * (c[3] + s * (c[4] + s * c[5]))));
+        }
+
+        //! A public static member function.
+        /*!
+            プロセスで共有するオブジェクトを返す（最初の呼び出しで表を生成する）
+            \return FermiDiracオブジェクト
+        */
+        static FermiDirac const & Instance();
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private static member function.
+        /*!
+            区間の両端の値と1階・2階の導関数から、5次のHermite多項式の係数を求める
+            \param f0 区間の左端の値と導関数
+            \param f1 区間の右端の値と導関数
+            \param h 区間の幅
+            \return 区間内の位置s∈[0, 1]の多項式の係数
+        */
+        static coefficient_type hermite(std::array<double, 3> const & f0, std::array<double, 3> const & f1, double h) noexcept;
+
+        //! A private static member function.
+        /*!
+            F_{1/2}(η)と、その1階・2階の導関数、およびF_{3/2}(η)を数値積分で求める
+            t = s^2と変数変換して、被積分関数を滑らかにしてから積分する
+            \param eta η
+            \return F_{1/2}(η)、dF_{1/2}/dη、d^2F_{1/2}/dη^2、F_{3/2}(η)
+        */
+        static std::array<double, 4> integral(double eta);
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant expression).
+        /*!
+            表の刻み幅の逆数
+        */
+        static auto constexpr DIVISION = 16.0;
+
+        //! A private member variable (constant expression).
+        /*!
+            表の上端
+        */
+        static auto constexpr ETA_MAX = 100.0;
+
+        //! A private member variable (constant expression).
+        /*!
+            表の下端
+        */
+        static auto constexpr ETA_MIN = -40.0;
+
+        //! A private member variable (constant expression).
+        /*!
+            Γ(3/2) = √π / 2
+        */
+        static auto constexpr GAMMA_3_2 = 0.886226925452758013649083741671;
+
+        //! A private member variable (constant expression).
+        /*!
+            表を生成するときの、一区間あたりのGauss-Legendre積分の分点
+        */
+        static auto constexpr QUADRATURE_NUM = 16;
+
+        //! A private member variable (constant expression).
+        /*!
+            表を生成するときの、積分区間（sの区間）の幅
+        */
+        static auto constexpr QUADRATURE_WIDTH = 0.1;
+
+        //! A private member variable.
+        /*!
+            各区間の補間多項式の係数
+        */
+        std::vector<coefficient_type> coef_;
+
+        //! A private member variable.
+        /*!
+            F_{3/2}の各区間の補間多項式の係数
+        */
+        std::vector<coefficient_type> coef32_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        FermiDirac(FermiDirac const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        FermiDirac & operator=(FermiDirac const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _FERMIDIRAC_H_
@@ -26,11 +26,11 @@ namespace thomasfermi {
 
         FOElement::FOElement(std::vector<double> && beta, std::vector<double> const & coords, std::size_t nint, bool useomp) :
             FEM(std::move(beta), coords, nint, useomp),
-            func_([this](double x) { return pbeta_->operator()<Element::First>(x); }),
+            func_([this](double x, std::size_t ielem) { return pbeta_->operator()<Element::First>(lnods_[ielem][0], x); }),
             fun1_([this](double r, double xl, std::size_t ielem)
-            { return -N1_(r) * func_(N1_(r) * coords_[lnods_[ielem][0]] + N2_(r) * coords_[lnods_[ielem][1]]) * xl * 0.5; }),
+            { return -N1_(r) * func_(N1_(r) * coords_[lnods_[ielem][0]] + N2_(r) * coords_[lnods_[ielem][1]], ielem) * xl * 0.5; }),
             fun2_([this](double r, double xl, std::size_t ielem)
-            { return -N2_(r) * func_(N1_(r) * coords_[lnods_[ielem][0]] + N2_(r) * coords_[lnods_[ielem][1]]) * xl * 0.5; })
+            { return -N2_(r) * func_(N1_(r) * coords_[lnods_[ielem][0]] + N2_(r) * coords_[lnods_[ielem][1]], ielem) * xl * 0.5; })
         {
             auto const N1tmp = [](double r) { return 0.5 * (1.0 - r); };
             N1_ = std::cref(N1tmp);
@@ -61,7 +61,9 @@ namespace thomasfermi {
         void FOElement::reset(std::vector<double> const & beta)
         {
             FEM::reset(beta);
-            func_ = [this](double x) { return pbeta_->operator()<Element::First>(x); };
+
+            // 積分点を含む要素はわかっているので、βを補間するときに節点を探索しない
+            func_ = [this](double x, std::size_t ielem) { return pbeta_->operator()<Element::First>(lnods_[ielem][0], x); };
         }
 
         // #endregion publicメンバ関数
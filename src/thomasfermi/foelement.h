@@ -107,9 +107,9 @@ namespace thomasfermi {
 
             //! A private member variable.
             /*!
-                double func(double)の形の関数オブジェクト
+                double func(double, std::size_t)の形の関数オブジェクト（要素の番号と座標からβを返す）
             */
-            std::function<double(double)> func_;
+            std::function<double(double, std::size_t)> func_;
 
             //! A private member variable (constant).
             /*!
@@ -38,10 +38,20 @@ namespace thomasfermi {
 
         // 引数の書式を定義
         opt.add_options()
+            ("counters,C", "反復の段階ごとに、ハードウェアカウンタ（Linuxのperf_event_open）も計測する")
             ("help,h", "ヘルプを表示")
             ("inputfile,I", value<std::string>()->default_value(GetComLineOption::DEFINPNAME), "インプットファイル名")
             ("omp,O", value<bool>()->implicit_value(false),
-             "OpenMPを使用して並列計算を行うかどうか（デフォルトはOpenMPを使用しない）");
+             "OpenMPを使用して並列計算を行うかどうか（デフォルトはOpenMPを使用しない）")
+            ("profile,P", value<std::string>(),
+             "反復の段階ごとの計測結果を書き込むファイル名（拡張子が.jsonならJSON形式、それ以外はCSV形式）")
+            ("restart,R", "チェックポイントファイル（scf.chk）から反復を再開する")
+            ("scaling-study", value<std::string>()->implicit_value("scaling.csv"),
+             "メッシュの分割数とスレッド数を変えて標準の問題を解き、結果を書き込むファイル名（拡張子が.jsonならJSON形式、それ以外はCSV形式）")
+            ("scaling-grid-max", value<std::uint32_t>()->default_value(10000000),
+             "--scaling-studyで解くメッシュの分割数の最大値")
+            ("serve,S", value<std::string>()->implicit_value("-"),
+             "UNIXドメインソケットのパス（省略すると標準入出力）でジョブを受け付けるサーバーとして動作する");
 
         // 引数の書式に従って実際に指定されたコマンドライン引数を解析
         variables_map vm;
@@ -62,6 +72,11 @@ namespace thomasfermi {
             return 1;
         }
 
+        // ハードウェアカウンタ指定がある場合
+        if (vm.count("counters")) {
+            counters_ = true;
+        }
+
         // インプットファイル名指定がある場合
         if (vm.count("inputfile")) {
             inpname_ = vm["inputfile"].as<std::string>();
@@ -72,14 +87,65 @@ namespace thomasfermi {
             useomp_ = vm["omp"].as<bool>();
         }
 
+        // プロファイル指定がある場合
+        if (vm.count("profile")) {
+            profile_ = vm["profile"].as<std::string>();
+        }
+
+        // 再開指定がある場合
+        if (vm.count("restart")) {
+            restart_ = true;
+        }
+
+        // スケーリングの測定指定がある場合
+        if (vm.count("scaling-study")) {
+            scalingstudy_ = vm["scaling-study"].as<std::string>();
+            scalinggridmax_ = vm["scaling-grid-max"].as<std::uint32_t>();
+        }
+
+        // サーバー指定がある場合
+        if (vm.count("serve")) {
+            serve_ = vm["serve"].as<std::string>();
+        }
+
         return 0;
     }
 
+    bool GetComLineOption::getcounters() const noexcept
+    {
+        return counters_;
+    }
+
     std::pair<std::string, bool> GetComLineOption::getpairdata() const
     {
         return std::make_pair(inpname_, useomp_);
     }
 
+    std::optional<std::string> const & GetComLineOption::getprofile() const noexcept
+    {
+        return profile_;
+    }
+
+    bool GetComLineOption::getrestart() const noexcept
+    {
+        return restart_;
+    }
+
+    std::uint32_t GetComLineOption::getscalinggridmax() const noexcept
+    {
+        return scalinggridmax_;
+    }
+
+    std::optional<std::string> const & GetComLineOption::getscalingstudy() const noexcept
+    {
+        return scalingstudy_;
+    }
+
+    std::optional<std::string> const & GetComLineOption::getserve() const noexcept
+    {
+        return serve_;
+    }
+
     // #endregion publicメンバ関数
 }
 
@@ -21,7 +21,8 @@
 
 #pragma once
 
-#include <cstdint>  // for std::int32_t
+#include <cstdint>  // for std::int32_t, std::uint32_t
+#include <optional> // for std::optional
 #include <string>   // for std::string
 #include <utility>  // for std::pair
 
@@ -66,6 +67,48 @@ namespace thomasfermi {
         */
         std::pair<std::string, bool> getpairdata() const;
 
+        //! A public member function (constant).
+        /*!
+            ハードウェアカウンタも計測するかどうかを返す
+            \return ハードウェアカウンタも計測するかどうか
+        */
+        bool getcounters() const noexcept;
+
+        //! A public member function (constant).
+        /*!
+            段階ごとの計測結果を書き込むファイル名を返す
+            \return ファイル名（拡張子が.jsonならJSON形式、それ以外はCSV形式、計測しないならstd::nullopt）
+        */
+        std::optional<std::string> const & getprofile() const noexcept;
+
+        //! A public member function (constant).
+        /*!
+            スケーリングの測定で解くメッシュの分割数の最大値を返す
+            \return メッシュの分割数の最大値
+        */
+        std::uint32_t getscalinggridmax() const noexcept;
+
+        //! A public member function (constant).
+        /*!
+            スケーリングの測定の結果を書き込むファイル名を返す
+            \return ファイル名（スケーリングを測定しないならstd::nullopt）
+        */
+        std::optional<std::string> const & getscalingstudy() const noexcept;
+
+        //! A public member function (constant).
+        /*!
+            サーバーとして動作するときの、UNIXドメインソケットのパスを返す
+            \return ソケットのパス（"-"なら標準入出力、サーバーとして動作しないならstd::nullopt）
+        */
+        std::optional<std::string> const & getserve() const noexcept;
+
+        //! A public member function (constant).
+        /*!
+            チェックポイントファイルから反復を再開するかどうかを返す
+            \return チェックポイントファイルから反復を再開するかどうか
+        */
+        bool getrestart() const noexcept;
+
         // #endregion メンバ関数
 
     private:
@@ -83,12 +126,48 @@ namespace thomasfermi {
         */
         std::string inpname_;
 
+        //!  A private member variable.
+        /*!
+            ハードウェアカウンタも計測するかどうか
+        */
+        bool counters_ = false;
+
+        //!  A private member variable.
+        /*!
+            チェックポイントファイルから反復を再開するかどうか
+        */
+        bool restart_ = false;
+
         //!  A private member variable.
         /*!
             OpenMPを使用するかどうか
         */
         bool useomp_ = false;
 
+        //!  A private member variable.
+        /*!
+            段階ごとの計測結果を書き込むファイル名
+        */
+        std::optional<std::string> profile_;
+
+        //!  A private member variable.
+        /*!
+            スケーリングの測定で解くメッシュの分割数の最大値
+        */
+        std::uint32_t scalinggridmax_ = 0;
+
+        //!  A private member variable.
+        /*!
+            スケーリングの測定の結果を書き込むファイル名
+        */
+        std::optional<std::string> scalingstudy_;
+
+        //!  A private member variable.
+        /*!
+            サーバーとして動作するときの、UNIXドメインソケットのパス
+        */
+        std::optional<std::string> serve_;
+
         // #endregion メンバ変数
 
         // #region 禁止されたコンストラクタ・メンバ関数
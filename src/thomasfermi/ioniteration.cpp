@@ -0,0 +1,598 @@
+﻿/*! \file ioniteration.cpp
+    \brief 有限の半径を持つイオンのThomas-Fermi方程式を反復法で解くクラスの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "foelement.h"
+#include "ioniteration.h"
+#include "gausslegendre/gausslegendre.h"
+#include "utility/chainsweep.h"
+#include "utility/csvwriter.h"
+#include <algorithm>                            // for std::max, std::max_element, std::min_element, std::sort
+#include <cmath>                                // for std::abs, std::cbrt, std::log, std::pow, std::sqrt
+#include <cstdio>                               // for std::fopen, std::fprintf
+#include <iostream>                             // for std::cout
+#include <stdexcept>                            // for std::runtime_error
+#include <tuple>                                // for std::get, std::make_tuple, std::tuple
+#include <utility>                              // for std::make_pair, std::pair
+#include <boost/assert.hpp>                     // for BOOST_ASSERT
+#include <boost/format.hpp>                     // for boost::format
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+#include <omp.h>                                // for omp_get_max_threads
+
+namespace thomasfermi {
+    namespace femall {
+        // #region コンストラクタ
+
+        template <typename Source>
+        IonIteration<Source>::IonIteration(std::shared_ptr<Data> const & pdata, Source const & source) :
+            pdata_(pdata),
+            pmix_(std::make_unique<mixing::SimpleMixing>(pdata)),
+            source_(source),
+            x0_(0.0)
+        {
+            // tの等間隔のメッシュを[t0, 1]に生成する（t0 = xmin / xmax）
+            auto const n = pdata_->grid_num_;
+            auto const t0 = pdata_->xmin_ / pdata_->xmax_;
+            auto const dt = (1.0 - t0) / static_cast<double>(n);
+
+            t_.resize(n + 1);
+            for (auto i = 0U; i < n; i++) {
+                t_[i] = t0 + static_cast<double>(i) * dt;
+            }
+            t_[n] = 1.0;
+
+            y_.assign(n + 1, 0.0);
+
+            // 係数行列はメッシュだけで決まるので、ここで一度だけ生成する
+            pfem_.reset(new femall::FOElement(std::vector<double>(n + 1, 0.0), t_, pdata_->gauss_legendre_integ_, pdata_->useomp_));
+            pfem_->stiff();
+
+            i_bc_given_ = { 0, pfem_->Nnode - 1 };
+            v_bc_nonzero_ = { 1.0, 0.0 };
+
+            ple_.emplace(pfem_->createresult());
+        }
+
+        // #endregion コンストラクタ
+
+        // #region publicメンバ関数
+
+        template <typename Source>
+        void IonIteration<Source>::Cellloop(double x0)
+        {
+            BOOST_ASSERT(x0 > 0.0);
+
+            // 初めて解くときは、Sommerfeldの近似解から始める
+            auto const first = x0_ == 0.0;
+            x0_ = x0;
+            if (first) {
+                initguess();
+            }
+
+            // dy/dt(1) - y1 + 1 = N / Z（Nはセル内の電子数）なので、g(y1) = log(N / Z)の根を、区間を広げながら探す
+            // y1を大きくするとセル内の電子数が増えるので、gはy1の増加関数
+            // 高温では電子数がy1の指数関数になるので、対数をとって割線法の予測が外れないようにする
+            auto const gfunc = [this](double y1) { return std::log(scfloop(y1) - y1 + 1.0); };
+
+            auto ya = y_.back();
+            auto ga = gfunc(ya);
+            if (std::abs(ga) < IonIteration::OUTER_TOL) {
+                return;
+            }
+
+            auto yb = ya + (ga < 0.0 ? IonIteration::EDGE_STEP : -IonIteration::EDGE_STEP);
+            auto gb = gfunc(yb);
+            for (auto i = 0U; ga * gb > 0.0; i++) {
+                if (i == IonIteration::OUTER_MAXITER) {
+                    throw std::runtime_error("境界値の探索区間が見つかりませんでした。");
+                }
+
+                // 割線法で予測した根を少し越えるところまで区間を広げる（傾きがおかしければ幅を倍にする）
+                auto const slope = (gb - ga) / (yb - ya);
+                auto const next = slope > 0.0 ?
+                    yb - IonIteration::EDGE_OVERSHOOT * gb / slope :
+                    yb + 2.0 * (yb - ya);
+
+                ya = yb;
+                ga = gb;
+                yb = next;
+                gb = gfunc(yb);
+            }
+
+            findroot(gfunc, ya, ga, yb, gb);
+        }
+
+        template <typename Source>
+        void IonIteration<Source>::Iterationloop(double q)
+        {
+            BOOST_ASSERT(q >= 0.0 && q < 1.0);
+
+            // 初めて解くときは、y ~ 144 / x^3のときのx0y'(x0) = -qから初期値を決める
+            // （中性原子のときは適当な値から始める）
+            if (x0_ == 0.0) {
+                x0_ = std::cbrt(432.0 / (q > 0.0 ? q : IonIteration::Q_INITIAL));
+                initguess();
+            }
+
+            // g(x0) = dy/dt(1) - y(1) + qの根を、区間を広げながら探す
+            auto const gfunc = [this, q](double x0) {
+                x0_ = x0;
+                return scfloop(source_.edge(x0_)) - y_.back() + q;
+            };
+
+            auto xa = x0_;
+            auto ga = gfunc(xa);
+            if (std::abs(ga) < IonIteration::OUTER_TOL) {
+                return;
+            }
+
+            auto const factor = ga < 0.0 ? 1.25 : 1.0 / 1.25;
+            auto xb = xa;
+            auto gb = ga;
+            for (auto i = 0U; ga * gb > 0.0; i++) {
+                if (i == IonIteration::OUTER_MAXITER) {
+                    throw std::runtime_error("半径の探索区間が見つかりませんでした。");
+                }
+
+                xa = xb;
+                ga = gb;
+                xb = xb * factor;
+                gb = gfunc(xb);
+            }
+
+            findroot(gfunc, xa, ga, xb, gb);
+        }
+
+        template <typename Source>
+        typename IonIteration<Source>::result_type IonIteration<Source>::makeresult() const
+        {
+            std::vector<double> x(t_.size());
+            for (auto i = 0U; i < t_.size(); i++) {
+                x[i] = x0_ * t_[i];
+            }
+
+            return std::make_tuple(std::move(x), y_, x0_, yprime0());
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+        template <typename Source>
+        double IonIteration<Source>::dydt1() const
+        {
+            auto const n = t_.size() - 1;
+            auto const h = t_[n] - t_[n - 1];
+
+            return (y_[n] - y_[n - 1]) / h + 0.5 * h * source_(x0_, t_[n], y_[n]);
+        }
+
+        template <typename Source>
+        template <typename Function>
+        void IonIteration<Source>::findroot(Function const & gfunc, double xa, double ga, double xb, double gb) const
+        {
+            auto side = 0;
+            for (auto i = 0U; i < IonIteration::OUTER_MAXITER; i++) {
+                auto const x = (xa * gb - xb * ga) / (gb - ga);
+                auto const g = gfunc(x);
+
+                if (std::abs(g) < IonIteration::OUTER_TOL || std::abs(xb - xa) < IonIteration::OUTER_TOL * std::max(std::abs(x), 1.0)) {
+                    return;
+                }
+
+                if (g * gb > 0.0) {
+                    xb = x;
+                    gb = g;
+                    if (side == -1) {
+                        ga *= 0.5;
+                    }
+                    side = -1;
+                }
+                else {
+                    xa = x;
+                    ga = g;
+                    if (side == 1) {
+                        gb *= 0.5;
+                    }
+                    side = 1;
+                }
+            }
+
+            throw std::runtime_error("反復が収束しませんでした。");
+        }
+
+        template <typename Source>
+        double IonIteration<Source>::GetNormRD() const
+        {
+            auto const size = y_.size();
+
+            auto const & yold(pmix_->Yold());
+
+            BOOST_ASSERT(size == yold.size());
+
+            auto sum = 0.0;
+            for (auto i = 0U; i < size; i++) {
+                sum += (y_[i] - yold[i]) * (y_[i] - yold[i]);
+            }
+
+            return std::sqrt(sum);
+        }
+
+        template <typename Source>
+        void IonIteration<Source>::initguess()
+        {
+            auto const lambda = 0.772;
+            for (auto i = 0U; i < t_.size(); i++) {
+                auto const x = x0_ * t_[i];
+                y_[i] = (1.0 - t_[i]) * std::pow(1.0 + std::pow(x * x * x / 144.0, lambda), -1.0 / lambda) + t_[i] * source_.edge(x0_);
+            }
+        }
+
+        template <typename Source>
+        std::vector<double> IonIteration<Source>::make_beta() const
+        {
+            BOOST_ASSERT(y_.size() == t_.size());
+            std::vector<double> beta;
+            source_(x0_, t_, y_, beta);
+
+            // βは原点付近でc/√tのように振る舞うので、線形補間すると最初の要素の積分が大きくずれる
+            // 節点0は既知量なので、節点1の形状関数N1との積分∫βN1dtが厳密な値に一致するように、節点0の値を補正する
+            auto const t0 = t_[0];
+            auto const t1 = t_[1];
+            auto const h = t1 - t0;
+            auto const c = beta[0] * std::sqrt(t0);
+            auto const exact = c / h * (2.0 / 3.0 * (t1 * std::sqrt(t1) - t0 * std::sqrt(t0)) - 2.0 * t0 * (std::sqrt(t1) - std::sqrt(t0)));
+            beta[0] = 6.0 / h * (exact - h * beta[1] / 3.0);
+
+            return beta;
+        }
+
+        template <typename Source>
+        double IonIteration<Source>::scfloop(double y1)
+        {
+            for (auto i = 1U; i < pdata_->iteration_maxiter_; i++) {
+                pfem_->reset(make_beta());
+                pfem_->stiff2();
+
+                // 原点に近い方の境界条件はy(t0) = 1 + y'(0)x + (4/3)x^(3/2)（x = x0t0）
+                auto const x = x0_ * t_[0];
+                v_bc_nonzero_[0] = 1.0 + yprime0() * x + 4.0 / 3.0 * x * std::sqrt(x);
+
+                // 原点から遠い方の境界条件はy(1) = y1
+                v_bc_nonzero_[1] = y1;
+
+                ple_->reset(pfem_->B);
+                ple_->bound<Element::First>(IonIteration::N_BC_GIVEN, i_bc_given_, IonIteration::N_BC_GIVEN, i_bc_given_, v_bc_nonzero_);
+
+                pmix_->Yold = y_;
+
+                ymix(ple_->LEsolverReuse<Element::First>());
+
+                // yの絶対値が大きいと丸め誤差も大きくなるので、収束判定条件をその分緩める
+                auto const scale = std::max(*std::max_element(y_.begin(), y_.end()), -*std::min_element(y_.begin(), y_.end()));
+                if (GetNormRD() < pdata_->iteration_criterion_ * std::max(scale, 1.0)) {
+                    return dydt1();
+                }
+            }
+
+            throw std::runtime_error("収束しませんでした。");
+        }
+
+        template <typename Source>
+        double IonIteration<Source>::yprime0() const
+        {
+            // x0y'(0) = dy/dt(1) - ∫(0～1)β(t)dtを使う
+            // β(t) = g(t) / √tとし、各要素でg(t)を線形補間して、1/√tの重み付きで厳密に積分する
+            auto const size = t_.size();
+            std::vector<double> g;
+            source_(x0_, t_, y_, g);
+            for (auto i = 0U; i < size; i++) {
+                g[i] *= std::sqrt(t_[i]);
+            }
+
+            // [0, t0]ではg(t)を定数とみなす
+            auto sum = 2.0 * g[0] * std::sqrt(t_[0]);
+            for (auto i = 0U; i < size - 1; i++) {
+                auto const a = t_[i];
+                auto const b = t_[i + 1];
+                auto const sa = std::sqrt(a);
+                auto const sb = std::sqrt(b);
+
+                // ∫(a～b)t^(-1/2)dtと∫(a～b)t^(1/2)dt
+                auto const i0 = 2.0 * (sb - sa);
+                auto const i1 = 2.0 / 3.0 * (b * sb - a * sa);
+
+                sum += (g[i] * (b * i0 - i1) + g[i + 1] * (i1 - a * i0)) / (b - a);
+            }
+
+            return (dydt1() - sum) / x0_;
+        }
+
+        template <typename Source>
+        void IonIteration<Source>::ymix(std::vector<double> const & y)
+        {
+            y_ = (*pmix_)(y);
+        }
+
+        // #endregion privateメンバ関数
+
+        // #region 非メンバ関数
+
+        template <typename Source>
+        void ionsweep(std::shared_ptr<Data> const & pdata)
+        {
+            // 解が原子番号によらないなら、最初の原子番号についてだけ解く
+            std::vector<double> Zlist(pdata->Zlist_);
+            if constexpr (!Source::ZDEPENDENT) {
+                Zlist.resize(1);
+            }
+
+            // 電離度が省略されていたら中性原子（q = 0）を解く
+            std::vector<double> qlist(pdata->ion_degree_);
+            if (qlist.empty()) {
+                qlist.push_back(0.0);
+            }
+
+            // 近いパラメータが続くように、原子番号、電離度の昇順に並べる
+            std::sort(Zlist.begin(), Zlist.end());
+            std::sort(qlist.begin(), qlist.end());
+
+            std::vector< std::pair<double, double> > jobs;
+            jobs.reserve(Zlist.size() * qlist.size());
+            for (auto const Z : Zlist) {
+                for (auto const q : qlist) {
+                    jobs.push_back(std::make_pair(Z, q));
+                }
+            }
+
+            auto const size = jobs.size();
+            std::vector<typename IonIteration<Source>::result_type> result(size);
+
+            auto const nchain = pdata->useomp_ ? static_cast<std::size_t>(omp_get_max_threads()) : 1U;
+
+            utility::chainsweep(size, nchain, [&pdata, &jobs, &result](std::size_t begin, std::size_t end) {
+                std::unique_ptr< IonIteration<Source> > piter;
+                for (auto i = begin; i < end; i++) {
+                    auto const [Z, q] = jobs[i];
+
+                    // 原子番号が変わったら、ソース項が変わるので作り直す
+                    if (!piter || (Source::ZDEPENDENT && Z != jobs[i - 1].first)) {
+                        piter = std::make_unique< IonIteration<Source> >(pdata, Source(Z));
+                    }
+
+                    piter->Iterationloop(q);
+                    result[i] = piter->makeresult();
+
+                    auto const filename = Source::ZDEPENDENT ?
+                        (boost::format("y_Z%g_q%g.csv") % Z % q).str() :
+                        (boost::format("y_q%g.csv") % q).str();
+
+                    utility::CsvWriter cw(filename);
+
+                    auto const & x(std::get<0>(result[i]));
+                    auto const & y(std::get<1>(result[i]));
+                    for (auto j = 0U; j < x.size(); j++) {
+                        cw(x[j], y[j]);
+                    }
+
+                    cw.close();
+                }
+            });
+
+            std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(Source::ZDEPENDENT ? "tfd.csv" : "ion.csv", "w"), std::fclose);
+            if (!fp) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            for (auto const Z : pdata->Zlist_) {
+                // 1 / a = [128 / (9π ** 2)]^(1 / 3) * Z^(1 / 3)
+                auto const alpha = std::pow(128.0 / (9.0 * std::pow(boost::math::constants::pi<double>(), 2)) * Z, 1.0 / 3.0);
+
+                for (auto i = 0U; i < size; i++) {
+                    if (Source::ZDEPENDENT && jobs[i].first != Z) {
+                        continue;
+                    }
+
+                    auto const q = jobs[i].second;
+                    auto const x0 = std::get<2>(result[i]);
+                    auto const yprime0 = std::get<3>(result[i]);
+
+                    if constexpr (Source::ZDEPENDENT) {
+                        // Thomas-Fermi-Dirac模型では、境界での値y(x0)も出力する
+                        auto const y1 = std::get<1>(result[i]).back();
+
+                        std::fprintf(fp.get(), "%g, %g, %.15f, %.15f, %.15f\n", Z, q, x0 / alpha, yprime0, y1);
+                        std::cout << boost::format("Z = %g, q = %g, r0 = %.15f (Bohr), y'(0) = %.15f\n") % Z % q % (x0 / alpha) % yprime0;
+                    }
+                    else {
+                        // E = (3 / 7)(Z^2 / a)[y'(0) + q^2 / x0]
+                        auto const energy = 3.0 / 7.0 * Z * Z * alpha * (yprime0 + q * q / x0);
+
+                        std::fprintf(fp.get(), "%g, %g, %.15f, %.15f, %.15f\n", Z, q, x0 / alpha, yprime0, energy);
+                        std::cout << boost::format("Z = %g, q = %g, r0 = %.15f (Bohr), Energy = %.15f (Hartree)\n") % Z % q % (x0 / alpha) % energy;
+                    }
+                }
+            }
+        }
+
+        template <typename Source>
+        void cellsweep(std::shared_ptr<Data> const & pdata)
+        {
+            // 1 Hartree（eV）、原子質量単位（g）、Bohr半径（cm）、1 Hartree / Bohr^3（GPa）
+            auto constexpr HARTREE = 27.211386245988;
+            auto constexpr AMU = 1.66053906660E-24;
+            auto constexpr BOHR = 5.29177210903E-9;
+            auto constexpr PRESSURE = 2.94210156965E4;
+
+            // 近いパラメータが続くように、原子番号、温度、密度の昇順に並べる
+            std::vector<double> Zlist(pdata->Zlist_);
+            std::vector<double> Tlist(pdata->temperature_);
+            std::vector<double> rholist(pdata->cell_density_);
+            std::sort(Zlist.begin(), Zlist.end());
+            std::sort(Tlist.begin(), Tlist.end());
+            std::sort(rholist.begin(), rholist.end());
+
+            // 絶対零度では、温度のリストの代わりにT = 0だけを解く
+            if constexpr (!Source::TDEPENDENT) {
+                Tlist.assign(1, 0.0);
+            }
+
+            std::vector< std::tuple<double, double, double> > jobs;
+            jobs.reserve(Zlist.size() * Tlist.size() * rholist.size());
+            for (auto const Z : Zlist) {
+                for (auto const T : Tlist) {
+                    for (auto const rho : rholist) {
+                        jobs.push_back(std::make_tuple(Z, T, rho));
+                    }
+                }
+            }
+
+            // セルの半径r0 = [3A / (4πρ)]^(1 / 3)（Bohr）
+            auto const cellradius = [&pdata](double rho) {
+                return std::cbrt(3.0 * pdata->atomic_mass_ * AMU / (4.0 * boost::math::constants::pi<double>() * rho)) / BOHR;
+            };
+
+            // 1 / b = [128 / (9π ** 2)]^(1 / 3) * Z^(1 / 3)
+            auto const alphafunc = [](double Z) {
+                return std::pow(128.0 / (9.0 * std::pow(boost::math::constants::pi<double>(), 2)) * Z, 1.0 / 3.0);
+            };
+
+            auto const size = jobs.size();
+            std::vector<typename IonIteration<Source>::result_type> result(size);
+
+            auto const nchain = pdata->useomp_ ? static_cast<std::size_t>(omp_get_max_threads()) : 1U;
+
+            utility::chainsweep(size, nchain, [&](std::size_t begin, std::size_t end) {
+                std::unique_ptr< IonIteration<Source> > piter;
+                for (auto i = begin; i < end; i++) {
+                    auto const [Z, T, rho] = jobs[i];
+
+                    // 原子番号か温度が変わったら、ソース項が変わるので作り直す
+                    // （ソース項がどちらにもよらなければ、直前の解を初期値にして半径だけ変える）
+                    if (!piter || (Source::ZDEPENDENT && Z != std::get<0>(jobs[i - 1])) || (Source::TDEPENDENT && T != std::get<1>(jobs[i - 1]))) {
+                        if constexpr (Source::TDEPENDENT) {
+                            piter = std::make_unique< IonIteration<Source> >(pdata, Source(Z, T / HARTREE));
+                        }
+                        else {
+                            piter = std::make_unique< IonIteration<Source> >(pdata, Source(Z));
+                        }
+                    }
+
+                    piter->Cellloop(cellradius(rho) * alphafunc(Z));
+                    result[i] = piter->makeresult();
+                }
+            });
+
+            std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(Source::TDEPENDENT ? "cell.csv" : "eos.csv", "w"), std::fclose);
+            if (!fp) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            for (auto i = 0U; i < size; i++) {
+                auto const [Z, T, rho] = jobs[i];
+                auto const r0 = cellradius(rho);
+
+                // 化学ポテンシャルμ = Zy(x0) / r0
+                auto const y1 = std::get<1>(result[i]).back();
+                auto const mu = Z * y1 / r0;
+                auto const yprime0 = std::get<3>(result[i]);
+
+                if constexpr (Source::TDEPENDENT) {
+                    // τ = bT / Z（ソース項のη = y / (xτ)で、境界ではη = μ / T）
+                    auto const Th = T / HARTREE;
+                    auto const b = 1.0 / alphafunc(Z);
+                    auto const tau = b * Th / Z;
+
+                    // 境界での電子の圧力P = (2√2 / (3π^2))T^(5/2)F_{3/2}(μ / T)（T → 0で(2μ)^(5/2) / (15π^2)になる）
+                    auto const t52 = Th * Th * std::sqrt(Th);
+                    auto const pressure = 2.0 * boost::math::constants::root_two<double>() / (3.0 * boost::math::constants::pi_sqr<double>()) *
+                        t52 * fermidirac::FermiDirac::Instance().threehalves(mu / Th);
+
+                    // 運動エネルギーK = (4√2 / π)T^(5/2)b^3∫(0～x0)F_{3/2}(y / (xτ))x^2dx
+                    auto const kinetic = 4.0 * boost::math::constants::root_two<double>() / boost::math::constants::pi<double>() * t52 * b * b * b *
+                        kineticintegral(std::get<0>(result[i]), std::get<1>(result[i]), tau, pdata->gauss_legendre_integ_);
+
+                    // ビリアル定理2K + U = 3PVから、内部エネルギーE = K + U = 3PV - K（V = (4π / 3)r0^3）
+                    auto const energy = 4.0 * boost::math::constants::pi<double>() * r0 * r0 * r0 * pressure - kinetic;
+
+                    std::fprintf(fp.get(), "%g, %g, %g, %.15f, %.15f, %.15e, %.15f, %.15f\n", Z, rho, T, r0, mu, pressure * PRESSURE, energy, yprime0);
+                    std::cout << boost::format("Z = %g, rho = %g (g/cm^3), T = %g (eV), r0 = %.15f (Bohr), mu = %.15f (Hartree), P = %.15e (GPa), Energy = %.15f (Hartree)\n")
+                        % Z % rho % T % r0 % mu % (pressure * PRESSURE) % energy;
+                }
+                else {
+                    // 境界での電子の圧力P = (2μ)^(5/2) / (15π^2)
+                    auto const pressure = std::pow(2.0 * std::max(mu, 0.0), 2.5) / (15.0 * boost::math::constants::pi_sqr<double>());
+
+                    // ビリアル定理2K + U = 3PVとEuler方程式から、E = (3 / 7)(Z^2 / b)[y'(0) + (2 / 15)x0^(1/2)y(x0)^(5/2)]
+                    auto const x0 = std::get<2>(result[i]);
+                    auto const energy = 3.0 / 7.0 * Z * Z * alphafunc(Z) * (yprime0 + 2.0 / 15.0 * std::sqrt(x0) * std::pow(std::max(y1, 0.0), 2.5));
+
+                    std::fprintf(fp.get(), "%g, %g, %.15f, %.15f, %.15e, %.15f, %.15f\n", Z, rho, r0, mu, pressure * PRESSURE, energy, yprime0);
+                    std::cout << boost::format("Z = %g, rho = %g (g/cm^3), r0 = %.15f (Bohr), P = %.15e (GPa), Energy = %.15f (Hartree)\n") % Z % rho % r0 % (pressure * PRESSURE) % energy;
+                }
+            }
+        }
+
+        double kineticintegral(std::vector<double> const & x, std::vector<double> const & y, double tau, std::int32_t n)
+        {
+            gausslegendre::Gauss_Legendre const gl(n);
+            auto const & glx(gl.X());
+            auto const & glw(gl.W());
+            auto const & fd(fermidirac::FermiDirac::Instance());
+
+            // メッシュの内側[0, x_0]ではyを一定とし、F_{3/2}(η) ~ (2/5)η^(5/2)として解析的に積分する
+            auto const eta0 = std::max(y.front(), 0.0) / tau;
+            auto sum = 0.8 * eta0 * eta0 * std::sqrt(eta0) * std::sqrt(x.front());
+
+            for (auto ielem = 0U; ielem < x.size() - 1; ielem++) {
+                auto const xa = x[ielem];
+                auto const xb = x[ielem + 1];
+                auto const ya = y[ielem];
+                auto const yb = y[ielem + 1];
+
+                // x = s^2とすると、被積分関数は2s^5F_{3/2}(y / (s^2τ))で、原点付近のx^(-1/2)の発散が消える
+                auto const sa = std::sqrt(xa);
+                auto const sb = std::sqrt(xb);
+
+                for (auto k = 0U; k < glx.size(); k++) {
+                    auto const s = sa + 0.5 * (sb - sa) * (1.0 + glx[k]);
+                    auto const xs = s * s;
+
+                    // yは要素内でxの一次関数（有限温度ではμ < 0のところでyが負になるので、0で打ち切らない）
+                    auto const ys = ya + (yb - ya) * (xs - xa) / (xb - xa);
+                    sum += (sb - sa) * glw[k] * xs * xs * s * fd.threehalves(ys / (xs * tau));
+                }
+            }
+
+            return sum;
+        }
+
+        // #endregion 非メンバ関数
+
+        // #region 明示的実体化
+
+        template class IonIteration<TFSource>;
+        template class IonIteration<TFDSource>;
+        template class IonIteration<FTSource>;
+        template void ionsweep<TFSource>(std::shared_ptr<Data> const & pdata);
+        template void ionsweep<TFDSource>(std::shared_ptr<Data> const & pdata);
+        template void cellsweep<TFSource>(std::shared_ptr<Data> const & pdata);
+        template void cellsweep<FTSource>(std::shared_ptr<Data> const & pdata);
+
+        // #endregion 明示的実体化
+    }
+}
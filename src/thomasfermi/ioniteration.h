@@ -0,0 +1,337 @@
+﻿/*! \file ioniteration.h
+    \brief 有限の半径を持つイオンのThomas-Fermi方程式を反復法で解くクラスの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _IONITERATION_H_
+#define _IONITERATION_H_
+
+#pragma once
+
+#include "data.h"
+#include "fem.h"
+#include "linearequations.h"
+#include "mixing/simplemixing.h"
+#include "source.h"
+#include <cstdint>                  // for std::int32_t
+#include <memory>                   // for std::shared_ptr, std::unique_ptr
+#include <optional>                 // for std::optional
+#include <tuple>                    // for std::tuple
+#include <vector>                   // for std::vector
+
+namespace thomasfermi {
+    namespace femall {
+        template <typename Source>
+        //! A template class.
+        /*!
+            電離度q = (Z - N) / Zの原子・イオンについて、境界条件
+            y(0) = 1, y(x0) = y1, x0y'(x0) - y(x0) = -q
+            を満たす微分方程式の解と半径x0を求めるクラス
+            t = x / x0と変数変換し、t∈[t0, 1]の固定されたメッシュ上で
+            d^2y/dt^2 = (ソース項)
+            を解くので、x0が変わっても係数行列とその分解は使い回せる
+            ソース項と境界値y1はポリシークラスSourceで与える（TFSource、TFDSource）
+            半径x0のセル（Wigner-Seitzセル）に閉じ込められた中性原子については、
+            x0を固定して、x0y'(x0) = y(x0)を満たす境界値y1を求める（TFSource、FTSource）
+        */
+        class IonIteration final {
+            // #region 型エイリアス
+
+        public:
+            using result_type = std::tuple<std::vector<double>, std::vector<double>, double, double>;
+
+            // #endregion 型エイリアス
+
+            // #region コンストラクタ・デストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param pdata インプットファイルのデータ
+                \param source ソース項のポリシー
+            */
+            IonIteration(std::shared_ptr<Data> const & pdata, Source const & source);
+
+            //! A default destructor.
+            /*!
+                デフォルトデストラクタ
+            */
+            ~IonIteration()
+            {
+                ple_ = std::nullopt;
+            }
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region publicメンバ関数
+
+            //! A public member function.
+            /*!
+                半径x0のセルに閉じ込められた中性原子について、境界値y1 = y(x0)とy(t)を求める
+                直前に解いた解を初期値として用いる（ウォームスタート）
+                \param x0 セルの半径
+            */
+            void Cellloop(double x0);
+
+            //! A public member function.
+            /*!
+                電離度qの原子・イオンについて、x0とy(t)を求める
+                直前に解いた解を初期値として用いる（ウォームスタート）
+                \param q 電離度（中性原子ならq = 0）
+            */
+            void Iterationloop(double q);
+
+            //! A public member function (const).
+            /*!
+                結果を返す関数
+                \return xのメッシュ、yの値、半径x0、y'(0)のstd::tuple
+            */
+            result_type makeresult() const;
+
+            // #endregion publicメンバ関数
+
+            // #region privateメンバ関数
+
+        private:
+            //! A private member function (const).
+            /*!
+                t = 1におけるyの微分値dy/dt(1) = x0y'(x0)を返す
+                \return dy/dt(1)
+            */
+            double dydt1() const;
+
+            template <typename Function>
+            //! A private member function (template function).
+            /*!
+                g(xa)とg(xb)の符号が異なる区間から、Illinois法でg(x) = 0の根を求める
+                \param gfunc 関数g
+                \param xa 区間の端点
+                \param ga g(xa)
+                \param xb 区間のもう一方の端点
+                \param gb g(xb)
+            */
+            void findroot(Function const & gfunc, double xa, double ga, double xb, double gb) const;
+
+            //! A private member function (const).
+            /*!
+                反復の誤差を返す
+                \return 反復の誤差
+            */
+            double GetNormRD() const;
+
+            //! A private member function.
+            /*!
+                Sommerfeldの近似解をyの初期値とする
+            */
+            void initguess();
+
+            //! A private member function (const).
+            /*!
+                βを生成する関数
+                \return β
+            */
+            std::vector<double> make_beta() const;
+
+            //! A private member function.
+            /*!
+                現在のx0と境界値y1について、Thomas-Fermi方程式を自己無撞着に解く
+                \param y1 境界（t = 1）におけるyの値
+                \return dy/dt(1)
+            */
+            double scfloop(double y1);
+
+            //! A private member function (const).
+            /*!
+                y'(0)を返す（原点付近で差分をとると精度が落ちるので、dy/dt(1)とβの積分から求める）
+                \return y'(0)
+            */
+            double yprime0() const;
+
+            //! A private member function.
+            /*!
+                yを合成する
+                \param y 新しいy
+            */
+            void ymix(std::vector<double> const & y);
+
+            // #endregion privateメンバ関数
+
+            // #region メンバ変数
+
+            //! A private member variable (constant expression).
+            /*!
+                セルの境界値y1の探索区間を広げるとき、割線法で予測した根を越える割合
+            */
+            static auto constexpr EDGE_OVERSHOOT = 1.5;
+
+            //! A private member variable (constant expression).
+            /*!
+                セルの境界値y1の探索区間を広げるときの最初の刻み幅
+            */
+            static auto constexpr EDGE_STEP = 0.01;
+
+            //! A private member variable (constant expression).
+            /*!
+                既知量の数
+            */
+            static auto constexpr N_BC_GIVEN = 2U;
+
+            //! A private member variable (constant expression).
+            /*!
+                x0（またはy1）を求める反復の最大回数
+            */
+            static auto constexpr OUTER_MAXITER = 200U;
+
+            //! A private member variable (constant expression).
+            /*!
+                x0（またはy1）を求める反復の収束判定条件
+            */
+            static auto constexpr OUTER_TOL = 1.0E-10;
+
+            //! A private member variable (constant expression).
+            /*!
+                中性原子のとき、x0の初期値を決めるのに使う電離度
+            */
+            static auto constexpr Q_INITIAL = 0.05;
+
+            //! A private member variable.
+            /*!
+                既知量のインデックス
+            */
+            std::vector<std::size_t> i_bc_given_;
+
+            //! A private member variable.
+            /*!
+                データオブジェクト
+            */
+            std::shared_ptr<Data> const pdata_;
+
+            //! A private member variable.
+            /*!
+                有限要素法オブジェクト
+            */
+            std::unique_ptr<FEM> pfem_;
+
+            //! A private member variable.
+            /*!
+                連立一次方程式のソルバーオブジェクト
+            */
+            std::optional<Linear_equations> ple_;
+
+            //! A private member variable.
+            /*!
+                yの混合法
+            */
+            std::unique_ptr<mixing::SimpleMixing> pmix_;
+
+            //! A private member variable (constant).
+            /*!
+                ソース項のポリシー
+            */
+            Source const source_;
+
+            //! A private member variable.
+            /*!
+                tのメッシュの可変長配列
+            */
+            std::vector<double> t_;
+
+            //! A private member variable.
+            /*!
+                既知量の値
+            */
+            std::vector<double> v_bc_nonzero_;
+
+            //! A private member variable.
+            /*!
+                原子・イオンの半径
+            */
+            double x0_;
+
+            //! A private member variable.
+            /*!
+                yの値の可変長配列
+            */
+            std::vector<double> y_;
+
+            // #endregion メンバ変数
+
+            // #region 禁止されたコンストラクタ・メンバ関数
+
+        public:
+            //! A default constructor (deleted).
+            /*!
+                デフォルトコンストラクタ（禁止）
+            */
+            IonIteration() = delete;
+
+            //! A copy constructor (deleted).
+            /*!
+                コピーコンストラクタ（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+            */
+            IonIteration(IonIteration const & dummy) = delete;
+
+            //! A public member function (deleted).
+            /*!
+                operator=()の宣言（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+                \return コピー元のオブジェクト
+            */
+            IonIteration & operator=(IonIteration const & dummy) = delete;
+
+            // #endregion 禁止されたコンストラクタ・メンバ関数
+        };
+
+        // #region 非メンバ関数
+
+        template <typename Source>
+        //! A template function.
+        /*!
+            電離度のリストについて原子・イオンの解を求め、結果をファイルに出力する
+            昇順に並べたリストをいくつかの連鎖に分け、連鎖ごとに一つのタスクで、
+            直前の解を初期値として順に解く
+            \param pdata インプットファイルのデータ
+        */
+        void ionsweep(std::shared_ptr<Data> const & pdata);
+
+        template <typename Source>
+        //! A template function.
+        /*!
+            原子番号、温度、密度のリストについて、セルに閉じ込められた原子の解を求め、結果をファイルに出力する
+            原子番号、温度、密度の昇順に並べたリストをいくつかの連鎖に分け、連鎖ごとに一つのタスクで、
+            直前の解を初期値として順に解く
+            絶対零度（TFSource）でも有限温度（FTSource）でも、境界での圧力と内部エネルギーも求めて出力する
+            \param pdata インプットファイルのデータ
+        */
+        void cellsweep(std::shared_ptr<Data> const & pdata);
+
+        //! A function.
+        /*!
+            有限温度の原子の運動エネルギーの積分∫(0～x0)F_{3/2}(y / (xτ))x^2dxを求める
+            \param x xのメッシュ
+            \param y 各節点におけるy(x)の値
+            \param tau 無次元化した温度τ = bT / Z
+            \param n 一要素あたりのGauss-Legendre積分の分点
+            \return 積分の値
+        */
+        double kineticintegral(std::vector<double> const & x, std::vector<double> const & y, double tau, std::int32_t n);
+
+        // #endregion 非メンバ関数
+    }
+}
+
+#endif  // _IONITERATION_H_
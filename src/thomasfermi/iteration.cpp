@@ -17,32 +17,41 @@
 */
 
 #include "foelement.h"
+#include "../checkpoint/profiler.h"
 #include "iteration.h"
-#include "readinputfile.h"
+#include "scfcheckpoint.h"
 #include "shoot/shootf.h"
 #include "soelement.h"
+#include "utility/chainsweep.h"
+#include <algorithm>        // for std::max, std::sort, std::upper_bound
+#include <chrono>           // for std::chrono
+#include <cmath>            // for std::isfinite, std::sqrt
+#include <cstdio>           // for std::fclose, std::fopen, std::fprintf
 #include <iostream>         // for std::cout
+#include <limits>           // for std::numeric_limits
 #include <stdexcept>        // for std::runtime_error
+#include <tuple>            // for std::get, std::make_tuple, std::tuple
+#include <utility>          // for std::move
 #include <boost/assert.hpp> // for BOOST_ASSERT
 #include <boost/format.hpp> // for boost::format
+#include <omp.h>            // for omp_get_max_threads
 
 namespace thomasfermi {
     namespace femall {
         // #region コンストラクタ・デストラクタ
 
-        Iteration::Iteration(std::pair<std::string, bool> const & arg) :
-            PData([this] { return std::cref(pdata_); }, nullptr)
+        Iteration::Iteration(std::shared_ptr<Data> const & pdata) :
+            PData([this] { return std::cref(pdata_); }, nullptr),
+            pdata_(pdata)
         {
             using namespace thomasfermi;
             using namespace thomasfermi::shoot;
 
-            // インプットファイルの読み込み
-            ReadInputFile rif(arg);
-            rif.readFile();
-            pdata_ = rif.PData;
-
-            // 混合法オブジェクトの生成
-            pmix_ = std::make_unique<mixing::SimpleMixing>(pdata_);
+            if (pdata_->restart_) {
+                // チェックポイントファイルから反復の状態を復元する（shooting法を省く）
+                restore();
+                return;
+            }
 
             // メッシュの間隔を求める
             auto const dx = pdata_->xmax_ / static_cast<double>(pdata_->grid_num_);
@@ -59,10 +68,12 @@ namespace thomasfermi {
                 shootfunc::V1,
                 l2.make_v2(pdata_->xmax_));
 
-            auto const usecilk = std::get<1>(arg);
+            auto const usecilk = pdata_->useomp_;
 
-            std::vector<double> xtmp, ytmp;
-            auto result = std::make_pair(xtmp, ytmp);
+            // 結果を格納する領域をあらかじめ確保しておく
+            shootf::result_type result;
+            result.first.reserve(pdata_->grid_num_ + 1);
+            result.second.reserve(pdata_->grid_num_ + 1);
 
 #if _OPENMP >= 200805
     #pragma omp parallel    // OpenMP並列領域の始まり
@@ -70,54 +81,105 @@ namespace thomasfermi {
 #endif
             s(usecilk, pdata_->xmin_, pdata_->xmax_, pdata_->match_point_, result);
 
-            std::tie(xtmp, ytmp) = result;
-
-            x_ = xtmp;
-            y_ = std::vector<double>(ytmp.cbegin(), ytmp.cend());
-            y1_ = ytmp[0];
-            y2_ = ytmp.back();
+            x_ = std::move(result.first);
+            y_ = std::move(result.second);
+            y1_ = y_.front();
+            y2_ = y_.back();
 
-            pmix_->Yold = y_;
-
-            pfem_.reset(new femall::FOElement(make_beta(), x_, pdata_->gauss_legendre_integ_, usecilk));
-            pfem_->stiff();
-
-            i_bc_given_.reserve(Iteration::N_BC_GIVEN);
+            initialize();
+        }
 
-            i_bc_given_ = { 0, pfem_->Nnode - 1 };
-            v_bc_nonzero_.reserve(Iteration::N_BC_GIVEN);
-            v_bc_nonzero_ = { y1_, y2_ };
+        Iteration::Iteration(std::shared_ptr<Data> const & pdata, Iteration const & guess) :
+            PData([this] { return std::cref(pdata_); }, nullptr),
+            pdata_(pdata)
+        {
+            makemesh();
+
+            // 収束した解を線形補間する（元のメッシュより外側では、y ~ 144 / x^3のように減衰させる）
+            auto const & xg(guess.x_);
+            auto const & yg(guess.y_);
+
+            auto const n = x_.size();
+            y_.resize(n);
+            for (auto i = 0U; i < n; i++) {
+                auto const x = x_[i];
+                if (x >= xg.back()) {
+                    auto const r = xg.back() / x;
+                    y_[i] = yg.back() * r * r * r;
+                    continue;
+                }
 
-            ple_.emplace(pfem_->createresult());
+                auto const j = static_cast<std::size_t>(std::upper_bound(xg.begin() + 1, xg.end(), x) - xg.begin()) - 1;
+                y_[i] = yg[j] + (yg[j + 1] - yg[j]) * (x - xg[j]) / (xg[j + 1] - xg[j]);
+            }
 
-            ple_->bound<Element::First>(Iteration::N_BC_GIVEN, i_bc_given_, Iteration::N_BC_GIVEN, i_bc_given_, v_bc_nonzero_);
+            // 境界条件はshooting法と同じ（原点に近い方は収束した解の値、遠い方はy0(x)の近似値）
+            y1_ = guess.y1_;
+            y2_ = shoot::load2()(pdata_->xmax_, 0.0)[0];
+            y_.front() = y1_;
+            y_.back() = y2_;
 
-            y_ = ple_->LEsolver<Element::First>();
+            initialize();
         }
 
         // #endregion コンストラクタ・デストラクタ
 
         // #region publicメンバ関数
 
-        void Iteration::Iterationloop()
+        std::uint32_t Iteration::Iterationloop(bool verbose)
         {
-            for (auto i = 1U; i < pdata_->iteration_maxiter_; i++) {
-                pfem_->reset(Iteration::make_beta());
+            // 一定の反復回数ごとに、反復の状態をチェックポイントファイルに書き出す
+            auto const interval = pdata_->checkpoint_interval_;
+            std::optional<ScfCheckpoint> checkpoint;
+            if (interval) {
+                checkpoint.emplace(ScfCheckpoint::FILENAME);
+            }
+
+            for (auto i = iter_ + 1; i < pdata_->iteration_maxiter_; i++) {
+                // 反復一回分と、その中の各段階の時間を計測する（プロファイラが無効なら何もしない）
+                checkpoint::ScopedTimer lap("iteration");
+
+                auto const beta = Iteration::make_beta();
+                lap.split("make_beta");
+
+                pfem_->reset(beta);
+                lap.split("reset");
+
                 pfem_->stiff2();
+                lap.split("stiff2");
 
                 ple_->reset(pfem_->B);
                 ple_->bound<Element::First>(Iteration::N_BC_GIVEN, i_bc_given_, Iteration::N_BC_GIVEN, i_bc_given_, v_bc_nonzero_);
+                lap.split("bound");
 
                 pmix_->Yold = y_;
 
-                ymix(ple_->LEsolver<Element::First>());
+                auto const y = ple_->LEsolver<Element::First>();
+                lap.split("solve");
+
+                ymix(y);
+                lap.split("mix");
 
                 auto const normrd = GetNormRD();
+                lap.split("norm");
+                iter_ = i;
+
+                if (verbose) {
+                    std::cout << "反復回数: " << i << "回, NormRD: " << boost::format("%.15f\n") % normrd;
+                }
 
-                std::cout << "反復回数: " << i << "回, NormRD: " << boost::format("%.15f\n") % normrd;
                 if (normrd < pdata_->iteration_criterion_) {
-                    pbeta_ = pfem_->PBeta;
-                    return;
+                    return i;
+                }
+
+                // 発散したら、最大ループ回数まで待たずに打ち切る
+                if (!std::isfinite(normrd)) {
+                    break;
+                }
+
+                // 書き込みは別のスレッドで行うので、ここではyを複製するだけ
+                if (checkpoint && !(i % interval)) {
+                    checkpoint->save({ ScfCheckpoint::makehash(*pdata_), i, y1_, y2_, y_ });
                 }
             }
 
@@ -127,7 +189,7 @@ namespace thomasfermi {
         Iteration::result_type Iteration::makeresult()
         {
             auto const y_prime_0 = (y_[1] - y_[0]) / (x_[1] - x_[0]);
-            return std::make_tuple(pbeta_, x_, y_prime_0);
+            return std::make_tuple(x_, y_, y_prime_0);
         }
 
         // #endregion publicメンバ関数
@@ -150,6 +212,13 @@ namespace thomasfermi {
             return std::sqrt(sum);
         }
 
+        void Iteration::initialize()
+        {
+            makesolver();
+
+            y_ = ple_->LEsolver<Element::First>();
+        }
+
         std::vector<double> Iteration::make_beta() const
         {
             auto const size = y_.size();
@@ -157,18 +226,164 @@ namespace thomasfermi {
             std::vector<double> beta(size);
 
             for (auto i = 0U; i < size; i++) {
-                beta[i] = y_[i] * std::sqrt(y_[i] / x_[i]);
+                auto const y = std::max(y_[i], 0.0);
+                beta[i] = y * std::sqrt(y / x_[i]);
             }
 
             return beta;
         }
 
+        void Iteration::makemesh()
+        {
+            // shooting法と同じメッシュを作る
+            auto const n = pdata_->grid_num_;
+            auto const dx = pdata_->xmax_ / static_cast<double>(n);
+
+            x_.resize(n + 1);
+            x_[0] = pdata_->xmin_;
+            for (auto i = 1U; i <= n; i++) {
+                x_[i] = static_cast<double>(i) * dx;
+            }
+        }
+
+        void Iteration::makesolver()
+        {
+            auto const usecilk = pdata_->useomp_;
+
+            // 混合法オブジェクトの生成
+            pmix_ = std::make_unique<mixing::SimpleMixing>(pdata_);
+            pmix_->Yold = y_;
+
+            pfem_.reset(new femall::FOElement(make_beta(), x_, pdata_->gauss_legendre_integ_, usecilk));
+            pfem_->stiff();
+
+            i_bc_given_.reserve(Iteration::N_BC_GIVEN);
+
+            i_bc_given_ = { 0, pfem_->Nnode - 1 };
+            v_bc_nonzero_.reserve(Iteration::N_BC_GIVEN);
+            v_bc_nonzero_ = { y1_, y2_ };
+
+            ple_.emplace(pfem_->createresult());
+
+            ple_->bound<Element::First>(Iteration::N_BC_GIVEN, i_bc_given_, Iteration::N_BC_GIVEN, i_bc_given_, v_bc_nonzero_);
+        }
+
+        void Iteration::restore()
+        {
+            auto state(ScfCheckpoint::load(ScfCheckpoint::FILENAME));
+            if (state.hash != ScfCheckpoint::makehash(*pdata_)) {
+                throw std::runtime_error("チェックポイントファイルの計算条件が、インプットファイルと一致しません。");
+            }
+
+            makemesh();
+            if (state.y.size() != x_.size()) {
+                throw std::runtime_error("チェックポイントファイルのメッシュの数が正しくありません。");
+            }
+
+            iter_ = state.iter;
+            y_ = std::move(state.y);
+            y1_ = state.y1;
+            y2_ = state.y2;
+
+            // 止まった反復の次の反復は、保存したyから始まる
+            makesolver();
+
+            std::cout << "チェックポイントファイルの反復回数" << iter_ << "回から再開します。\n";
+        }
+
         void Iteration::ymix(std::vector<double> const & y)
         {
             y_ = (*pmix_)(y);
         }
 
         // #endregion privateメンバ関数
+
+        // #region 非メンバ関数
+
+        void paramsweep(std::shared_ptr<Data> const & pdata)
+        {
+            // 近いパラメータが続くように、マッチングポイント、重み、メッシュの最大値、メッシュの数の昇順に並べる
+            std::vector<double> matchlist(pdata->sweep_match_point_);
+            std::vector<double> weightlist(pdata->sweep_mixing_weight_);
+            std::vector<double> xmaxlist(pdata->sweep_xmax_);
+            std::vector<double> numlist(pdata->sweep_grid_num_);
+            std::sort(matchlist.begin(), matchlist.end());
+            std::sort(weightlist.begin(), weightlist.end());
+            std::sort(xmaxlist.begin(), xmaxlist.end());
+            std::sort(numlist.begin(), numlist.end());
+
+            std::vector< std::tuple<double, double, double, double> > jobs;
+            jobs.reserve(matchlist.size() * weightlist.size() * xmaxlist.size() * numlist.size());
+            for (auto const match : matchlist) {
+                for (auto const weight : weightlist) {
+                    for (auto const xmax : xmaxlist) {
+                        for (auto const num : numlist) {
+                            jobs.push_back(std::make_tuple(match, weight, xmax, num));
+                        }
+                    }
+                }
+            }
+
+            // ウォームスタートしたかどうか、反復回数、y'(0)、計算時間（msec）
+            auto const size = jobs.size();
+            std::vector< std::tuple<bool, std::uint32_t, double, double> > result(size);
+
+            auto const nchain = pdata->useomp_ ? static_cast<std::size_t>(omp_get_max_threads()) : 1U;
+
+            utility::chainsweep(size, nchain, [&pdata, &jobs, &result](std::size_t begin, std::size_t end) {
+                std::unique_ptr<Iteration> piter;
+                for (auto i = begin; i < end; i++) {
+                    auto const [match, weight, xmax, num] = jobs[i];
+
+                    auto const pjob = std::make_shared<Data>(*pdata);
+                    pjob->grid_num_ = static_cast<std::uint32_t>(num);
+                    pjob->iteration_mixing_weight_ = weight;
+                    pjob->match_point_ = match;
+                    pjob->xmax_ = xmax;
+
+                    // 一つのファイルを複数のジョブで書き換えないように、チェックポイントは使わない
+                    pjob->checkpoint_interval_ = 0;
+                    pjob->restart_ = false;
+
+                    auto const start = std::chrono::high_resolution_clock::now();
+
+                    // 直前のジョブとマッチングポイントと重みが同じなら、その解を初期関数にする
+                    auto const warm = piter && match == std::get<0>(jobs[i - 1]) && weight == std::get<1>(jobs[i - 1]);
+
+                    // 収束しなかったジョブは反復回数を0として記録し、次のジョブはshooting法から始める
+                    auto iter = 0U;
+                    auto yprime0 = std::numeric_limits<double>::quiet_NaN();
+                    try {
+                        piter = warm ? std::make_unique<Iteration>(pjob, *piter) : std::make_unique<Iteration>(pjob);
+                        iter = piter->Iterationloop(false);
+                        yprime0 = std::get<2>(piter->makeresult());
+                    }
+                    catch (std::runtime_error const &) {
+                        piter.reset();
+                    }
+
+                    auto const elapsed = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+                    result[i] = std::make_tuple(warm, iter, yprime0, elapsed);
+                }
+            });
+
+            std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen("sweep.csv", "w"), std::fclose);
+            if (!fp) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            for (auto i = 0U; i < size; i++) {
+                auto const [match, weight, xmax, num] = jobs[i];
+                auto const [warm, iter, yprime0, elapsed] = result[i];
+                auto const start = !iter ? "failed" : warm ? "warm" : "shoot";
+
+                std::fprintf(fp.get(), "%g, %g, %g, %g, %s, %u, %.15f, %.4f\n", num, xmax, match, weight, start, iter, yprime0, elapsed);
+                std::cout << boost::format("grid.num = %g, xmax = %g, matching.point = %g, weight = %g, start = %s, iteration = %u, y'(0) = %.15f, time = %.4f (msec)\n")
+                    % num % xmax % match % weight % start % iter % yprime0 % elapsed;
+            }
+        }
+
+        // #endregion 非メンバ関数
     }
 }
 
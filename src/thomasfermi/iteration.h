@@ -27,6 +27,8 @@
 #include "mixing/simplemixing.h"
 #include "shoot/shootfunc.h"
 #include "utility/property.h"
+#include <cstdint>                  // for std::uint32_t
+#include <memory>                   // for std::shared_ptr
 #include <optional>                 // for std::nullopt, std::optional
 
 namespace thomasfermi {
@@ -35,7 +37,7 @@ namespace thomasfermi {
             // #region 型エイリアス
 
         public:
-            using result_type = std::tuple<std::shared_ptr<Beta>, std::vector<double>, double const>;
+            using result_type = std::tuple<std::vector<double>, std::vector<double>, double>;
 
             // #endregion 型エイリアス
 
@@ -43,10 +45,18 @@ namespace thomasfermi {
 
             //! A constructor.
             /*!
-                唯一のコンストラクタ
-                \param arg インプットファイル名とOpenMPを使用するかどうかのstd::pair
+                shooting法で初期関数を作るコンストラクタ（pdata->restart_ならチェックポイントファイルから再開する）
+                \param pdata インプットファイルのデータ
             */
-            explicit Iteration(std::pair<std::string, bool> const & arg);
+            explicit Iteration(std::shared_ptr<Data> const & pdata);
+
+            //! A constructor.
+            /*!
+                収束した解を初期関数にするコンストラクタ（shooting法を省く）
+                \param pdata インプットファイルのデータ
+                \param guess 初期関数に使う、収束したIterationオブジェクト
+            */
+            Iteration(std::shared_ptr<Data> const & pdata, Iteration const & guess);
 
             //! A default destructor.
             /*!
@@ -64,13 +74,15 @@ namespace thomasfermi {
             //! A public member function.
             /*!
                 反復関数
+                \param verbose 反復ごとに誤差を表示するかどうか
+                \return 収束するまでの反復回数
             */
-            void Iterationloop();
+            std::uint32_t Iterationloop(bool verbose);
 
             //! A public member function.
             /*!
                 結果を返す関数
-                \return 結果
+                \return x方向のメッシュ、収束したy(x)、原点に近いxにおけるyの微分値のstd::tuple
             */
             result_type makeresult();
             
@@ -84,6 +96,12 @@ namespace thomasfermi {
                 \return 反復の誤差
             */
             double GetNormRD() const;
+
+            //! A private member function.
+            /*!
+                x_とy_の初期関数から、有限要素法と連立一次方程式のオブジェクトを生成する
+            */
+            void initialize();
             
             //! A private member function (const).
             /*!
@@ -92,6 +110,24 @@ namespace thomasfermi {
             */
             std::vector<double> make_beta() const;
 
+            //! A private member function.
+            /*!
+                shooting法と同じx方向のメッシュを作る
+            */
+            void makemesh();
+
+            //! A private member function.
+            /*!
+                x_とy_から、有限要素法と連立一次方程式のオブジェクトを生成する（y_は変えない）
+            */
+            void makesolver();
+
+            //! A private member function.
+            /*!
+                チェックポイントファイルから、止まったところの反復の状態を復元する
+            */
+            void restore();
+
             //! A private member function.
             /*!
                 yを合成する
@@ -128,10 +164,10 @@ namespace thomasfermi {
 
             //! A private member variable.
             /*!
-                βオブジェクト
+                終わった反復の回数
             */
-            std::shared_ptr<Beta> pbeta_;
-            
+            std::uint32_t iter_ = 0;
+
             //!  A private member variable.
             /*!
                 データオブジェクト
@@ -213,6 +249,22 @@ namespace thomasfermi {
 
             // #endregion 禁止されたコンストラクタ・メンバ関数
         };
+
+        // #region 非メンバ関数
+
+        //! A function.
+        /*!
+            メッシュの数、メッシュの最大値、マッチングポイント、重みのリストの全ての組み合わせについて
+            孤立した中性原子の解を求め、反復回数と計算時間を一つの表にまとめてファイルに出力する
+            マッチングポイント、重み、メッシュの最大値、メッシュの数の昇順に並べたリストをいくつかの連鎖に分け、
+            連鎖の中で直前のジョブとマッチングポイントと重みが同じときは、直前の解を新しいメッシュに補間して
+            初期関数にする（それ以外はshooting法で初期関数を作る）
+            収束しなかったジョブは、表に反復回数0として記録して次のジョブに進む
+            \param pdata インプットファイルのデータ
+        */
+        void paramsweep(std::shared_ptr<Data> const & pdata);
+
+        // #endregion 非メンバ関数
     }
 
     template <typename T>
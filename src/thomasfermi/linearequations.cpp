@@ -30,6 +30,7 @@ namespace thomasfermi {
                 a1back_(a1_),
                 a2_(std::get<2>(res)),
                 b_(std::get<3>(res)),
+                factorized_(false),
                 n_(std::get<0>(res).size())
         {
         }
@@ -27,7 +27,7 @@
 #include <tuple>                // for std::tuple
 #include <vector>               // for std::vector
 #include <boost/format.hpp>     // for boost::format
-#include <mkl_lapack.h>         // for dptsv_, dpbsv_
+#include <mkl_lapack.h>         // for dptsv_, dpbsv_, dpttrf_, dpttrs_
 
 namespace thomasfermi {
     namespace femall {
@@ -89,6 +89,16 @@ namespace thomasfermi {
             */
             std::vector<double> LEsolver();
 
+            template <Element E>
+            //! A public member function.
+            /*!
+                連立一次方程式の解を求める
+                係数行列は最初の呼び出しでのみ分解し、以降はその分解を再利用する
+                （係数行列と境界条件が呼び出しごとに変わらない場合にのみ使用できる）
+                \return 連立一次方程式の解
+            */
+            std::vector<double> LEsolverReuse();
+
             // #endregion publicメンバ関数
 
             // #region メンバ変数
@@ -130,6 +140,24 @@ namespace thomasfermi {
             */
             std::vector<double> b_;
 
+            //! A private member variable.
+            /*!
+                分解済みの係数行列の対角要素
+            */
+            std::vector<double> d_;
+
+            //! A private member variable.
+            /*!
+                分解済みの係数行列の副対角要素
+            */
+            std::vector<double> e_;
+
+            //! A private member variable.
+            /*!
+                係数行列を分解済みかどうか
+            */
+            bool factorized_;
+
             //! A private member variable (constant).
             /*!
                 ベクトルの要素数
@@ -284,6 +312,51 @@ namespace thomasfermi {
             return b_;
         }
 
+        template <>
+        inline std::vector<double> Linear_equations::LEsolverReuse<Element::First>()
+        {
+            auto n = static_cast<std::int32_t>(n_);
+            auto nrhs = 1;
+
+            std::int32_t info;
+            if (!factorized_) {
+                d_ = a0_;
+                e_ = a1_;
+
+                // 係数行列をLDL^T分解する
+                dpttrf_(&n, d_.data(), e_.data(), &info);
+
+                if (info > 0) {
+                    throw std::logic_error("U is singular");
+                }
+                else if (info < 0) {
+                    auto const str = (boost::format("%d-th argument has illegal value") % std::abs(info)).str();
+
+                    throw std::invalid_argument(str);
+                }
+
+                factorized_ = true;
+            }
+
+            // 分解済みの係数行列を使って解く
+            dpttrs_(
+                &n,
+                &nrhs,
+                d_.data(),
+                e_.data(),
+                b_.data(),
+                &n,
+                &info);
+
+            if (info < 0) {
+                auto const str = (boost::format("%d-th argument has illegal value") % std::abs(info)).str();
+
+                throw std::invalid_argument(str);
+            }
+
+            return b_;
+        }
+
         // #endregion templateメンバ関数の実装
     }
 }
@@ -0,0 +1,129 @@
+﻿/*! \file densitytable.cpp
+    \brief 収束したy(x)の表から、任意の原子番号と半径の電子密度を求めるクラスの実装
+
+    Copyright © 2014 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#include "densitytable.h"
+#include "makerhoenergy.h"
+#include "../utility/mappedresult.h"
+#include <algorithm>                            // for std::max, std::min
+#include <cmath>                                // for std::cbrt, std::fabs, std::fmax, std::fmin, std::sqrt
+#include <stdexcept>                            // for std::runtime_error
+#include <utility>                              // for std::make_pair
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace thomasfermi {
+    namespace makerhoen {
+        // #region コンストラクタ
+
+        DensityTable::DensityTable(std::vector<double> const & x, std::vector<double> const & y)
+        {
+            initialize(x, y);
+        }
+
+        DensityTable::DensityTable(std::string const & filename)
+        {
+            utility::MappedResult const mr(filename);
+
+            auto const * const x = mr.column("x");
+            auto const * const y = mr.column("y");
+            if (!x || !y) {
+                throw std::runtime_error("y(x)のバイナリファイルではありません。");
+            }
+
+            auto const nrow = static_cast<std::size_t>(mr.header().nrow);
+            initialize(std::vector<double>(x, x + nrow), std::vector<double>(y, y + nrow));
+        }
+
+        // #endregion コンストラクタ
+
+        // #region publicメンバ関数
+
+        double DensityTable::operator()(double Z, double r) const noexcept
+        {
+            double out;
+            (*this)(Z, &r, &out, 1);
+
+            return out;
+        }
+
+        void DensityTable::operator()(double Z, double const * r, double * out, std::size_t n) const noexcept
+        {
+            auto const [alpha, c] = scale(Z);
+
+            auto const * const a = a_.data();
+            auto const * const b = b_.data();
+            auto const last = a_.size() - 1;
+            auto const kmax = static_cast<double>(last);
+
+            // メッシュは等間隔なので、区間の番号はx / dxの整数部で、二分探索は要らない
+            // メッシュの外側の要素も、いったん端の区間の一次関数で計算しておく（分岐のないループにするため）
+            // std::fmaxはNaNを0にするので、rがNaNでも範囲外の区間を読まない
+#if _OPENMP >= 201307
+    #pragma omp simd
+#endif
+            for (auto i = 0U; i < n; i++) {
+                auto const x = alpha * r[i];
+                auto const k = static_cast<std::size_t>(std::fmin(std::fmax(x * dxinv_, 0.0), kmax));
+                auto const q = std::max(a[k] + b[k] * x, 0.0) / x;
+                out[i] = c * q * std::sqrt(q);
+            }
+
+            // メッシュの外側の要素は、y ~ x^(-3)の漸近形で置き換える
+            for (auto i = 0U; i < n; i++) {
+                auto const x = alpha * r[i];
+                if (x > xmax_) {
+                    auto const s = xmax_ / x;
+                    auto const q = ymax_ * s * s * s / x;
+                    out[i] = c * q * std::sqrt(q);
+                }
+            }
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+        void DensityTable::initialize(std::vector<double> const & x, std::vector<double> const & y)
+        {
+            auto const size = x.size();
+            if (size < 3 || y.size() != size) {
+                throw std::runtime_error("y(x)の表が正しくありません。");
+            }
+
+            // x_0 = xmin、x_i = i * dx（i >= 1）でなければならない
+            auto const dx = x[2] - x[1];
+            if (std::fabs(x.back() - static_cast<double>(size - 1) * dx) > 1.0E-6 * x.back()) {
+                throw std::runtime_error("y(x)のメッシュが等間隔ではありません。");
+            }
+
+            dxinv_ = 1.0 / dx;
+            xmax_ = x.back();
+            ymax_ = std::max(y.back(), 0.0);
+
+            // 区間kのy = a_k + b_k * x
+            a_.resize(size - 1);
+            b_.resize(size - 1);
+            for (auto k = 0U; k < size - 1; k++) {
+                b_[k] = (y[k + 1] - y[k]) / (x[k + 1] - x[k]);
+                a_[k] = y[k] - b_[k] * x[k];
+            }
+
+            gausslegendre::Gauss_Legendre const gl(DensityTable::QUADRATURE_NUM);
+            norm_ = MakeRhoEnergy::integrate(x, y, gl, false)[0];
+        }
+
+        std::pair<double, double> DensityTable::scale(double Z) const noexcept
+        {
+            auto const pi = boost::math::constants::pi<double>();
+
+            // α^3 = 128Z / (9π ** 2)
+            auto const alpha3 = 128.0 / (9.0 * pi * pi) * Z;
+            return std::make_pair(std::cbrt(alpha3), Z * alpha3 / (4.0 * pi * norm_));
+        }
+
+        // #endregion privateメンバ関数
+    }
+}
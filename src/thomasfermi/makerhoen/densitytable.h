@@ -0,0 +1,175 @@
+﻿/*! \file densitytable.h
+    \brief 収束したy(x)の表から、任意の原子番号と半径の電子密度を求めるクラスの宣言
+
+    Copyright © 2014 @dc1394 All Rights Reserved.
+    This software is released under the BSD 2-Clause License.
+*/
+
+#ifndef _DENSITYTABLE_H_
+#define _DENSITYTABLE_H_
+
+#pragma once
+
+#include <cstddef>  // for std::size_t
+#include <string>   // for std::string
+#include <utility>  // for std::pair
+#include <vector>   // for std::vector
+
+namespace thomasfermi {
+    namespace makerhoen {
+        //! A class.
+        /*!
+            中性原子のThomas-Fermi方程式の解y(x)は原子番号によらないので、一度求めた表から
+            n(r; Z) = Zα^3 / (4π) * (y(x) / x)^(3/2)（x = αr、α = [128 / (9π ** 2)]^(1 / 3) * Z^(1 / 3)）
+            として、任意の原子番号と半径の電子密度（∫n(r)4πr^2dr = Z）を求めるクラス
+            構築した後は読み込み専用なので、一つのオブジェクトを複数のスレッドで共有できる
+        */
+        class DensityTable final {
+            // #region コンストラクタ・デストラクタ
+
+        public:
+            //! A constructor.
+            /*!
+                収束したy(x)から表を生成するコンストラクタ
+                \param x x方向のメッシュ（x_0 = xmin、x_i = i * dx）
+                \param y 各節点におけるy(x)の値
+            */
+            DensityTable(std::vector<double> const & x, std::vector<double> const & y);
+
+            //! A constructor.
+            /*!
+                output.binaryで出力したy.binから表を生成するコンストラクタ
+                \param filename y.binのファイル名
+            */
+            explicit DensityTable(std::string const & filename);
+
+            //! A default destructor.
+            /*!
+                デフォルトデストラクタ
+            */
+            ~DensityTable() = default;
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region publicメンバ関数
+
+            //! A public member function (const).
+            /*!
+                電子密度n(r; Z)を返す
+                \param Z 原子番号
+                \param r 原点からの距離（原子単位、正の値）
+                \return 電子密度（原子単位）
+            */
+            double operator()(double Z, double r) const noexcept;
+
+            //! A public member function (const).
+            /*!
+                n個の半径について、まとめて電子密度n(r; Z)を求める
+                ループはSIMD化されるように書いてある
+                rが負の値かNaNの要素は、電子密度がNaN（または-0）になる
+                \param Z 原子番号
+                \param r 原点からの距離（原子単位、正の値）の配列
+                \param out 電子密度を格納する配列
+                \param n 配列の要素数
+            */
+            void operator()(double Z, double const * r, double * out, std::size_t n) const noexcept;
+
+            // #endregion publicメンバ関数
+
+            // #region privateメンバ関数
+
+        private:
+            //! A private member function.
+            /*!
+                区間ごとの一次関数の係数と、規格化の定数を求める
+                \param x x方向のメッシュ
+                \param y 各節点におけるy(x)の値
+            */
+            void initialize(std::vector<double> const & x, std::vector<double> const & y);
+
+            //! A private member function (const).
+            /*!
+                原子番号から、x = αrのαとn(r; Z) = c(y / x)^(3/2)のcを求める
+                \param Z 原子番号
+                \return αとcのstd::pair
+            */
+            std::pair<double, double> scale(double Z) const noexcept;
+
+            // #endregion privateメンバ関数
+
+            // #region メンバ変数
+
+            //! A private member variable (constant expression).
+            /*!
+                規格化の積分を行うときの、一要素あたりのGauss-Legendre積分の分点
+            */
+            static auto constexpr QUADRATURE_NUM = 5;
+
+            //! A private member variable.
+            /*!
+                区間ごとのy = a + bxのa
+            */
+            std::vector<double> a_;
+
+            //! A private member variable.
+            /*!
+                区間ごとのy = a + bxのb
+            */
+            std::vector<double> b_;
+
+            //! A private member variable.
+            /*!
+                メッシュの刻み幅の逆数
+            */
+            double dxinv_;
+
+            //! A private member variable.
+            /*!
+                規格化の積分∫(0～∞)√x y(x)^(3/2)dx（厳密には1）
+            */
+            double norm_;
+
+            //! A private member variable.
+            /*!
+                メッシュの最大値
+            */
+            double xmax_;
+
+            //! A private member variable.
+            /*!
+                メッシュの最大値におけるy(x)の値（その外側はy ~ x^(-3)で外挿する）
+            */
+            double ymax_;
+
+            // #endregion メンバ変数
+
+            // #region 禁止されたコンストラクタ・メンバ関数
+
+        public:
+            //! A default constructor (deleted).
+            /*!
+                デフォルトコンストラクタ（禁止）
+            */
+            DensityTable() = delete;
+
+            //! A copy constructor (deleted).
+            /*!
+                コピーコンストラクタ（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+            */
+            DensityTable(DensityTable const & dummy) = delete;
+
+            //! A public member function (deleted).
+            /*!
+                operator=()の宣言（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+                \return コピー元のオブジェクト
+            */
+            DensityTable & operator=(DensityTable const & dummy) = delete;
+
+            // #endregion 禁止されたコンストラクタ・メンバ関数
+        };
+    }
+}
+
+#endif  // _DENSITYTABLE_H_
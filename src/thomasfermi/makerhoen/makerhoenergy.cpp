@@ -1,13 +1,22 @@
 ﻿/*! \file makerhoenergy.cpp
-    \brief β(x)から電子密度とエネルギーを計算してファイルに記録するクラスの実装
+    \brief y(x)から電子密度とエネルギーを計算してファイルに記録するクラスの実装
 
     Copyright © 2014 @dc1394 All Rights Reserved.
     This software is released under the BSD 2-Clause License.
 */
 
 #include "makerhoenergy.h"
-#include <cmath>                                // for std::exp, std::pow
-#include <iostream>                             // for std::cout
+#include "../utility/csvwriter.h"
+#include "../utility/decimator.h"
+#include "../utility/resultwriter.h"
+#include <algorithm>                            // for std::max, std::min
+#include <cmath>                                // for std::exp, std::pow, std::sqrt
+#include <cstdio>                               // for FILE, std::fclose, std::fopen
+#include <exception>                            // for std::current_exception, std::exception_ptr, std::rethrow_exception
+#include <iostream>                             // for std::cout, std::flush
+#include <memory>                               // for std::unique_ptr
+#include <stdexcept>                            // for std::runtime_error
+#include <tuple>                                // for std::apply
 #include <utility>                              // for std::get
 #include <boost/format.hpp>                     // for boost::format
 #include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
@@ -16,35 +25,166 @@ namespace thomasfermi {
     namespace makerhoen {
         // #region コンストラクタ
 
-        MakeRhoEnergy::MakeRhoEnergy(std::int32_t n, MakeRhoEnergy::parameter_type const & pt, double Z) :
+        MakeRhoEnergy::MakeRhoEnergy(std::int32_t n, MakeRhoEnergy::parameter_type const & pt, double Z, bool useomp) :
             alpha_(std::pow(128.0 / (9.0 * std::pow(boost::math::constants::pi<double>(), 2)) * Z, 1.0 / 3.0)),
             Z_(Z),
             b_(32.0 / (9.0 * std::pow(boost::math::constants::pi<double>(), 3)) * Z_ * Z_),
-            xvec_(std::get<1>(pt)),
+            xvec_(std::get<0>(pt)),
+            yvec_(std::get<1>(pt)),
             dx_(xvec_[2] - xvec_[1]),
-            fp_(nullptr, std::fclose),
             gl_(n),
-            pbeta_(std::get<0>(pt)),
+            useomp_(useomp),
             size_(xvec_.size()),
-            max_(boost::numeric_cast<std::int32_t>(xvec_[size_ - 1] / alpha_ / dx_)),
-            y_prime_0_(std::get<2>(pt))
+            max_(boost::numeric_cast<std::int32_t>(xvec_[size_ - 1] / alpha_ / dx_))
         {
-            s_ = 4.0 * boost::math::constants::pi<double>() / (gl_.qgauss(
-                [this](double x) { return std::sqrt(x) * y(x) * std::sqrt(y(x)); },
-                xvec_.front(),
-                xvec_.back()) * Z_);
+            auto const [norm, i, j] = integrate(xvec_, yvec_, gl_, useomp_);
+            s_ = 4.0 * boost::math::constants::pi<double>() / (norm * Z_);
+
+            // 原子核からのポテンシャルはZy(x) / rで、ρ(r) = Z / (4πb^3)(y / x)^(3/2)（b = 1 / α）だから、
+            // I = ∫y^(3/2) / √x dx、J = ∫y^(5/2) / √x dxとすると（単位はZ^2α）
+            // 運動エネルギーT = (3 / 5)J、電子-原子核E_ne = -I、電子間E_ee = (I - J) / 2
+            // （Thomas-Fermi方程式からI = -y'(0)、J = (5 / 7)Iで、ビリアル定理-V / T = 2を満たす）
+            auto const c = Z_ * Z_ * alpha_;
+            energy_ = { 0.6 * c * j, -c * i, 0.5 * c * (i - j) };
         }
 
         // #endregion コンストラクタ
 
         // #region publicメンバ関数
 
-        void MakeRhoEnergy::saveresult()
+        double MakeRhoEnergy::makeenergy() const noexcept
+        {
+            return energy_[0] + energy_[1] + energy_[2];
+        }
+
+        MakeRhoEnergy::energy_type const & MakeRhoEnergy::makeenergycomponents() const noexcept
         {
+            return energy_;
+        }
+
+        void MakeRhoEnergy::saveresult(bool binary, double tolerance)
+        {
+            auto const [t, ene, eee] = energy_;
             std::cout << boost::format("Energy = %.15f (Hartree)\n") % makeenergy();
-            saverho("rho.csv");
-            saverhoTilde("rhoTilde.csv");
-            savey("y.csv");
+            std::cout << boost::format("T = %.15f, E_ne = %.15f, E_ee = %.15f (Hartree), -V/T = %.15f\n") % t % ene % eee % (-(ene + eee) / t) << std::flush;
+            savefiles("", binary, tolerance);
+        }
+
+        void MakeRhoEnergy::savefiles(std::string const & suffix, bool binary, double tolerance)
+        {
+            using savefunc_type = void (MakeRhoEnergy::*)(std::string const &, bool, double) const;
+
+            // 三つのファイルは互いに独立なので、それぞれ自分のバッファとファイルを持つタスクで書き出す
+            std::array<savefunc_type, 3> const savefunc = { &MakeRhoEnergy::saverho, &MakeRhoEnergy::saverhoTilde, &MakeRhoEnergy::savey };
+            std::array<char const *, 3> const name = { "rho", "rhoTilde", "y" };
+            std::array<std::exception_ptr, 3> error;
+
+            auto const func = [this, &suffix, binary, tolerance, &savefunc, &name, &error](std::size_t i) {
+                try {
+                    (this->*savefunc[i])(name[i] + suffix, binary, tolerance);
+                }
+                catch (...) {
+                    error[i] = std::current_exception();
+                }
+            };
+
+            if (useomp_) {
+#if _OPENMP >= 200805
+    #pragma omp parallel    // OpenMP並列領域の始まり
+    #pragma omp single      // task句はsingle領域で実行
+#endif
+                for (auto i = 0U; i < savefunc.size(); i++) {
+#if _OPENMP >= 200805
+    #pragma omp task firstprivate(i)
+#endif
+                    func(i);
+                }
+            }
+            else {
+                for (auto i = 0U; i < savefunc.size(); i++) {
+                    func(i);
+                }
+            }
+
+            for (auto const & e : error) {
+                if (e) {
+                    std::rethrow_exception(e);
+                }
+            }
+        }
+
+        std::array<double, 3> MakeRhoEnergy::integrate(std::vector<double> const & x,
+                                                       std::vector<double> const & y,
+                                                       gausslegendre::Gauss_Legendre const & gl,
+                                                       bool useomp)
+        {
+            auto const & glx(gl.X());
+            auto const & glw(gl.W());
+
+            auto const nelem = x.size() - 1;
+            std::vector< std::array<double, 3> > e(nelem);
+
+            auto const func = [&x, &y, &glx, &glw, &e](std::size_t ielem) {
+                auto const xa = x[ielem];
+                auto const xb = x[ielem + 1];
+                auto const ya = std::max(y[ielem], 0.0);
+                auto const yb = std::max(y[ielem + 1], 0.0);
+
+                // x = t^2とすると、dx = 2tdt、dx / √x = 2dtで、被積分関数は要素内で滑らかになる
+                auto const ta = std::sqrt(xa);
+                auto const tb = std::sqrt(xb);
+
+                std::array<double, 3> sum = { 0.0, 0.0, 0.0 };
+                for (auto k = 0U; k < glx.size(); k++) {
+                    auto const t = ta + 0.5 * (tb - ta) * (1.0 + glx[k]);
+                    auto const wt = (tb - ta) * glw[k];
+
+                    // yは要素内でxの一次関数
+                    auto const yt = std::max(ya + (yb - ya) * (t * t - xa) / (xb - xa), 0.0);
+                    auto const y32 = yt * std::sqrt(yt);
+
+                    sum[0] += wt * t * t * y32;
+                    sum[1] += wt * y32;
+                    sum[2] += wt * y32 * yt;
+                }
+
+                e[ielem] = sum;
+            };
+
+            if (useomp) {
+                auto const n = static_cast<std::int32_t>(nelem);
+#pragma omp parallel for
+                for (auto ielem = 0; ielem < n; ielem++) {
+                    func(static_cast<std::size_t>(ielem));
+                }
+            }
+            else {
+                for (auto ielem = 0U; ielem < nelem; ielem++) {
+                    func(ielem);
+                }
+            }
+
+            // メッシュの内側[0, xmin]ではyを一定、外側[xmax, ∞)ではy ~ x^(-3)とみなして解析的に積分する
+            auto const y0 = std::max(y.front(), 0.0);
+            auto const yn = std::max(y.back(), 0.0);
+            auto const x0 = x.front();
+            auto const xn = x.back();
+            auto const y032 = y0 * std::sqrt(y0);
+            auto const yn32 = yn * std::sqrt(yn);
+
+            std::array<double, 3> sum = {
+                2.0 / 3.0 * x0 * std::sqrt(x0) * y032 + xn * std::sqrt(xn) * yn32 / 3.0,
+                2.0 * std::sqrt(x0) * y032 + 0.25 * std::sqrt(xn) * yn32,
+                2.0 * std::sqrt(x0) * y032 * y0 + std::sqrt(xn) * yn32 * yn / 7.0
+            };
+
+            for (auto const & ei : e) {
+                for (auto k = 0U; k < sum.size(); k++) {
+                    sum[k] += ei[k];
+                }
+            }
+
+            return sum;
         }
 
         // #endregion publicメンバ関数
@@ -61,55 +201,178 @@ namespace thomasfermi {
             return 4.0 * std::pow(Z_, 3) * std::exp(-2.0 * Z_ * r);
         }
 
-        double MakeRhoEnergy::makeenergy() const noexcept
+        double MakeRhoEnergy::rho(double x) const noexcept
         {
-            return 3.0 / 7.0 * alpha_ * std::pow(Z_, 7.0 / 3.0) * y_prime_0_;
+            auto const yx = y(x);
+            return s_ * b_ / (alpha_ * alpha_) * std::sqrt(x) * yx * std::sqrt(yx);
         }
 
-        double MakeRhoEnergy::rho(double x) const noexcept
+        double MakeRhoEnergy::rhoTilde(double x) const noexcept
         {
-            return s_ * b_ * std::pow(1.0 / alpha_, 2) * std::sqrt(x) * y(x) * std::sqrt(y(x));
+            auto const yx = y(x) / x;
+            return s_ * b_ * yx * std::sqrt(yx);
         }
 
-        double MakeRhoEnergy::rhoTilde(double x) const noexcept
+        void MakeRhoEnergy::savebinary(std::string const & filename,
+                                       std::initializer_list<char const *> names,
+                                       std::initializer_list<std::vector<double> const *> columns,
+                                       double first,
+                                       double step) const
         {
-            return s_ * b_ * (y(x) / x) * std::sqrt(y(x) / x);
+            std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(filename.c_str(), "wb"), std::fclose);
+            if (!fp) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            utility::writeresult(fp.get(), names, columns, Z_, alpha_, first, step);
+
+            // 閉じるときにバッファの残りが書き出されるので、その失敗も確かめる
+            if (std::fclose(fp.release())) {
+                throw std::runtime_error("ファイルを閉じられませんでした。");
+            }
         }
 
-        void MakeRhoEnergy::saverho(std::string const & filename)
+        template <std::size_t N>
+        void MakeRhoEnergy::savecsv(std::string const & filename,
+                                    std::vector<double> const & x,
+                                    std::array<std::vector<double> const *, N> const & columns,
+                                    double tolerance)
         {
-            fp_.reset(std::fopen(filename.c_str(), "w"));
+            utility::CsvWriter cw(filename);
+
+            auto const write = [&cw](double xi, std::array<double, N> const & v) {
+                std::apply([&cw, xi](auto... vi) { cw(xi, vi...); }, v);
+            };
+
+            auto const row = [&columns](std::size_t i) {
+                std::array<double, N> v;
+                for (auto k = 0U; k < N; k++) {
+                    v[k] = (*columns[k])[i];
+                }
+
+                return v;
+            };
 
+            if (tolerance > 0.0) {
+                utility::Decimator<N> dec(tolerance);
+                for (auto i = 0U; i < x.size(); i++) {
+                    dec(x[i], row(i), write);
+                }
+
+                dec.finish(write);
+            }
+            else {
+                for (auto i = 0U; i < x.size(); i++) {
+                    write(x[i], row(i));
+                }
+            }
+
+            cw.close();
+        }
+
+        void MakeRhoEnergy::saverho(std::string const & name, bool binary, double tolerance) const
+        {
+            std::vector<double> rv(max_), rhov(max_), exactv(max_);
             for (auto i = 1; i <= max_; i++) {
                 auto const r = static_cast<double>(i) * dx_;
-                std::fprintf(fp_.get(), "%.15f, %.15f, %.15f\n", r, rho(alpha_ * r), exactrho(r));
+                rv[i - 1] = r;
+                rhov[i - 1] = rho(alpha_ * r);
+                exactv[i - 1] = exactrho(r);
+            }
+
+            savecsv<2>(name + ".csv", rv, { &rhov, &exactv }, tolerance);
+
+            if (binary) {
+                savebinary(name + ".bin", { "r", "rho", "exactrho" }, { &rv, &rhov, &exactv }, dx_, dx_);
             }
         }
 
-        void MakeRhoEnergy::saverhoTilde(std::string const & filename)
+        void MakeRhoEnergy::saverhoTilde(std::string const & name, bool binary, double tolerance) const
         {
-            fp_.reset(std::fopen(filename.c_str(), "w"));
-
+            std::vector<double> rv(max_), rhov(max_), exactv(max_);
             for (auto i = 1; i <= max_; i++) {
                 auto const r = static_cast<double>(i) * dx_;
-                std::fprintf(fp_.get(), "%.15f, %.15f, %.15f\n", r, rhoTilde(alpha_ * r), exactrhoTilde(r));
+                rv[i - 1] = r;
+                rhov[i - 1] = rhoTilde(alpha_ * r);
+                exactv[i - 1] = exactrhoTilde(r);
+            }
+
+            savecsv<2>(name + ".csv", rv, { &rhov, &exactv }, tolerance);
+
+            if (binary) {
+                savebinary(name + ".bin", { "r", "rhoTilde", "exactrhoTilde" }, { &rv, &rhov, &exactv }, dx_, dx_);
             }
         }
                 
-        void MakeRhoEnergy::savey(std::string const & filename)
+        void MakeRhoEnergy::savey(std::string const & name, bool binary, double tolerance) const
         {
-            fp_.reset(std::fopen(filename.c_str(), "w"));
+            savecsv<1>(name + ".csv", xvec_, { &yvec_ }, tolerance);
 
-            for (auto const x : xvec_) {
-                std::fprintf(fp_.get(), "%.15f, %.15f\n", x, y(x));
+            if (binary) {
+                savebinary(name + ".bin", { "x", "y" }, { &xvec_, &yvec_ }, xvec_.front(), dx_);
             }
         }
 
-        double MakeRhoEnergy::y(double x) const
+        double MakeRhoEnergy::y(double x) const noexcept
         {
-            return std::pow(x * pbeta_->operator()<femall::Element::First>(x) * pbeta_->operator()<femall::Element::First>(x), 1.0 / 3.0);
+            // x_0 = xmin、x_i = i * dx（i >= 1）なので、xを含む区間の左端の節点の番号はx / dxの整数部
+            auto const k = std::min(static_cast<std::size_t>(x / dx_), size_ - 2);
+            auto const yx = yvec_[k] + (yvec_[k + 1] - yvec_[k]) * (x - xvec_[k]) / (xvec_[k + 1] - xvec_[k]);
+
+            return std::max(yx, 0.0);
         }
 
         // #endregion privateメンバ関数
+
+        // #region 非メンバ関数
+
+        void saveresultbatch(std::int32_t n, MakeRhoEnergy::parameter_type const & pt, std::vector<double> const & Zlist, bool useomp, bool binary, double tolerance)
+        {
+            auto const size = Zlist.size();
+            std::vector<MakeRhoEnergy::energy_type> energy(size);
+            std::vector<std::exception_ptr> error(size);
+
+            // (x, y, y'(0))の表は読み込み専用なので、すべてのタスクで共有する
+            auto const func = [n, &pt, &Zlist, &energy, &error, binary, tolerance](std::size_t i) {
+                try {
+                    // 原子番号ごとのタスクが並列に走るので、タスクの中ではOpenMPを使わない
+                    MakeRhoEnergy mre(n, pt, Zlist[i], false);
+                    energy[i] = mre.makeenergycomponents();
+                    mre.savefiles((boost::format("_Z%g") % Zlist[i]).str(), binary, tolerance);
+                }
+                catch (...) {
+                    error[i] = std::current_exception();
+                }
+            };
+
+            if (useomp) {
+#if _OPENMP >= 200805
+    #pragma omp parallel    // OpenMP並列領域の始まり
+    #pragma omp single      // task句はsingle領域で実行
+#endif
+                for (auto i = 0U; i < size; i++) {
+#if _OPENMP >= 200805
+    #pragma omp task firstprivate(i)
+#endif
+                    func(i);
+                }
+            }
+            else {
+                for (auto i = 0U; i < size; i++) {
+                    func(i);
+                }
+            }
+
+            for (auto i = 0U; i < size; i++) {
+                if (error[i]) {
+                    std::rethrow_exception(error[i]);
+                }
+
+                auto const [t, ene, eee] = energy[i];
+                std::cout << boost::format("Z = %g, Energy = %.15f (Hartree), -V/T = %.15f\n") % Zlist[i] % (t + ene + eee) % (-(ene + eee) / t);
+            }
+        }
+
+        // #endregion 非メンバ関数
     }
 }
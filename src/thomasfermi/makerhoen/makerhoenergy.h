@@ -1,5 +1,5 @@
 /*! \file MakeRhoEnergy.h
-    \brief β(x)から電子密度とエネルギーを計算してファイルに記録するクラスの宣言
+    \brief y(x)から電子密度とエネルギーを計算してファイルに記録するクラスの宣言
 
     Copyright ©  2014 @dc1394 All Rights Reserved.
     This software is released under the BSD 2-Clause License.
@@ -10,12 +10,14 @@
 
 #pragma once
 
-#include "../beta.h"
 #include "../gausslegendre/gausslegendre.h"
+#include <array>                            // for std::array
+#include <cstddef>                          // for std::size_t
 #include <cstdint>                          // for std::int32_t
-#include <cstdio>                           // for FILE, std::fclose
-#include <memory>                           // for std::shared_ptr
+#include <initializer_list>                 // for std::initializer_list
+#include <string>                           // for std::string
 #include <tuple>                            // for std::tuple
+#include <vector>                           // for std::vector
 
 namespace thomasfermi {
     namespace makerhoen {
@@ -24,23 +26,26 @@ namespace thomasfermi {
             y(x)から電子密度とエネルギーを計算する
         */
         class MakeRhoEnergy final {
+        public:
             // #region 型エイリアス
 
-            using parameter_type = std::tuple<std::shared_ptr<femall::Beta>, std::vector<double>, double const>;
+            using energy_type = std::array<double, 3>;
+
+            using parameter_type = std::tuple<std::vector<double>, std::vector<double>, double>;
 
             // #endregion 型エイリアス
 
-        public:
             // #region コンストラクタ・デストラクタ
 
             //! A constructor.
             /*!
                 唯一のコンストラクタ
-                \param n Gauss-Legendreの分点
-                \param pt std::vector<double>、std::shared_ptr<Beta>、doubleのstd::tuple
+                \param n 一要素あたりのGauss-Legendreの分点
+                \param pt x方向のメッシュ、収束したy(x)、y'(0)のstd::tuple
                 \param Z 原子番号
+                \param useomp OpenMPを使用するかどうか
             */
-            MakeRhoEnergy(std::int32_t n, parameter_type const & pt, double Z);
+            MakeRhoEnergy(std::int32_t n, parameter_type const & pt, double Z, bool useomp);
 
             //! A default destructor.
             /*!
@@ -52,11 +57,53 @@ namespace thomasfermi {
 
             // #region publicメンバ関数
 
+            //! A public member function (const).
+            /*!
+                原子のエネルギーを求める
+                \return 原子のエネルギー
+            */
+            double makeenergy() const noexcept;
+
+            //! A public member function (const).
+            /*!
+                原子のエネルギーの各成分を返す
+                \return 運動エネルギー、電子-原子核間の相互作用エネルギー、電子間の相互作用エネルギー
+            */
+            energy_type const & makeenergycomponents() const noexcept;
+
+            //! A public static member function.
+            /*!
+                規格化の積分∫(0～∞)√x y(x)^(3/2)dxと、エネルギーの積分∫(0～∞)y(x)^(3/2) / √x dx、
+                ∫(0～∞)y(x)^(5/2) / √x dxを、要素ごとのGauss-Legendre積分の和で求める
+                各要素ではt = √xと変数変換して、原点の特異性を被積分関数から取り除く
+                \param x x方向のメッシュ
+                \param y 各節点におけるy(x)の値
+                \param gl 一要素あたりのGauss-Legendre積分を行うオブジェクト
+                \param useomp OpenMPを使用するかどうか
+                \return 三つの積分値
+            */
+            static std::array<double, 3> integrate(std::vector<double> const & x,
+                                                   std::vector<double> const & y,
+                                                   gausslegendre::Gauss_Legendre const & gl,
+                                                   bool useomp);
+
+            //! A public member function.
+            /*!
+                エネルギーを表示し、計算結果をファイルに出力する
+                \param binary CSVファイルに加えてバイナリファイルにも出力するかどうか
+                \param tolerance CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
+            */
+            void saveresult(bool binary, double tolerance);
+
             //! A public member function.
             /*!
                 計算結果をファイルに出力する
+                OpenMPを使用するときは、三つのファイルを別々のタスクで並列に書き出す
+                \param suffix ファイル名（拡張子を除く）の末尾に付ける文字列
+                \param binary CSVファイルに加えてバイナリファイルにも出力するかどうか
+                \param tolerance CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
             */
-            void saveresult();
+            void savefiles(std::string const & suffix, bool binary, double tolerance);
 
             // #endregion publicメンバ関数
 
@@ -79,13 +126,6 @@ namespace thomasfermi {
             */
             double exactrhoTilde(double r) const noexcept;
 
-            //! A private member function (const).
-            /*!
-                原子のエネルギーを求める
-                \return 原子のエネルギーを求める
-            */
-            double makeenergy() const noexcept;
-
             //! A private member function (const).
             /*!
                 xを引数にとり、関数ρ(x)の値を返す
@@ -102,35 +142,72 @@ namespace thomasfermi {
             */
             double rhoTilde(double x) const noexcept;
 
-            //! A private member function.
+            //! A private member function (const).
             /*!
-                関数ρ(x)の値をファイルに書き込む
+                列ごとの値をバイナリファイルに書き込む
                 \param filename 書き込むファイル名
+                \param names 列の名前
+                \param columns 列の値（すべて同じ長さ）
+                \param first メッシュの最初の点
+                \param step メッシュの刻み幅
             */
-            void saverho(std::string const & filename);
+            void savebinary(std::string const & filename,
+                            std::initializer_list<char const *> names,
+                            std::initializer_list<std::vector<double> const *> columns,
+                            double first,
+                            double step) const;
+
+            template <std::size_t N>
+            //! A private static member function (template function).
+            /*!
+                列ごとの値をCSVファイルに書き込む
+                toleranceが正のときは、残した行の線形補間が間引いた行の値を相対誤差tolerance以内で
+                再現するように、一度の走査で行を間引く
+                \param filename 書き込むファイル名
+                \param x 最初の列（昇順）
+                \param columns 残りの列
+                \param tolerance 行を間引くときの相対誤差の許容値（0なら間引かない）
+            */
+            static void savecsv(std::string const & filename,
+                                std::vector<double> const & x,
+                                std::array<std::vector<double> const *, N> const & columns,
+                                double tolerance);
 
-            //! A private member function.
+            //! A private member function (const).
+            /*!
+                関数ρ(x)の値をファイルに書き込む
+                \param name 書き込むファイル名（拡張子を除く）
+                \param binary CSVファイルに加えてバイナリファイルにも出力するかどうか
+                \param tolerance CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
+            */
+            void saverho(std::string const & name, bool binary, double tolerance) const;
+
+            //! A private member function (const).
             /*!
                 関数ρ~(x)の値をファイルに書き込む
-                \param filename コピー元のオブジェクト（禁止）
-                \return コピー元のオブジェクト
+                \param name 書き込むファイル名（拡張子を除く）
+                \param binary CSVファイルに加えてバイナリファイルにも出力するかどうか
+                \param tolerance CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
             */
-            void saverhoTilde(std::string const & filename);
+            void saverhoTilde(std::string const & name, bool binary, double tolerance) const;
 
-            //! A private member function.
+            //! A private member function (const).
             /*!
                 関数y(x)の値をファイルに書き込む
-                \param filename 書き込むファイル名
+                \param name 書き込むファイル名（拡張子を除く）
+                \param binary CSVファイルに加えてバイナリファイルにも出力するかどうか
+                \param tolerance CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
             */
-            void savey(std::string const & filename);
+            void savey(std::string const & name, bool binary, double tolerance) const;
 
-            //! A private member function.
+            //! A private member function (const).
             /*!
-                関数y(x)の値を返す
+                関数y(x)の値を、節点の値の表から一次補間して返す
+                メッシュは等間隔なので、xを含む区間は二分探索せずに求まる
                 \param x xの値
                 \return y(x)の値
             */
-            double y(double x) const;
+            double y(double x) const noexcept;
 
             // #endregion privateメンバ関数
 
@@ -162,32 +239,38 @@ namespace thomasfermi {
 
             //! A private variable (constant).
             /*!
-                x方向のメッシュの刻み幅
+                x方向のメッシュの各節点におけるy(x)の値が格納された動的配列
             */
-            double const dx_;
+            std::vector<double> const yvec_;
 
             //! A private variable (constant).
             /*!
-                ファイルポインタ
+                x方向のメッシュの刻み幅
             */
-            std::unique_ptr<FILE, decltype(&std::fclose)> fp_;
+            double const dx_;
 
             //! A private variable (constant).
             /*!
-                Gauss-Legendreの積分を行うオブジェクト
+                要素ごとのGauss-Legendre積分を行うオブジェクト
             */
             gausslegendre::Gauss_Legendre const gl_;
 
             //! A private variable (constant).
             /*!
-                Betaクラスのオブジェクトへのスマートポインタ
+                OpenMPを使用するかどうか
             */
-            std::shared_ptr<femall::Beta> const pbeta_;
+            bool const useomp_;
+
+            //! A private variable.
+            /*!
+                運動エネルギー、電子-原子核間の相互作用エネルギー、電子間の相互作用エネルギー
+            */
+            energy_type energy_;
 
             //! A private variable.
             /*!
                 規格化のための定数
-                s_ = 1.0 / (∫(0～∞)√x[y(x)]^(3/2)dx)
+                s_ = 4π / (Z∫(0～∞)√x[y(x)]^(3/2)dx)
             */
             double s_;
 
@@ -203,12 +286,6 @@ namespace thomasfermi {
             */
             std::int32_t const max_;
 
-            //! A private member variable.
-            /*!
-                原点に近いxにおけるyの微分値
-            */
-            double const y_prime_0_;
-
             // #endregion メンバ変数
 
         public:
@@ -237,6 +314,23 @@ namespace thomasfermi {
 
             // #endregion 禁止されたコンストラクタ・メンバ関数
         };
+
+        // #region 非メンバ関数
+
+        //! A function.
+        /*!
+            一度求めたy(x)から、複数の原子番号について電子密度とエネルギーを計算し、
+            原子番号ごとに一つのタスクでファイルに出力する
+            \param n 一要素あたりのGauss-Legendreの分点
+            \param pt x方向のメッシュ、収束したy(x)、y'(0)のstd::tuple
+            \param Zlist 原子番号のリスト
+            \param useomp OpenMPを使用するかどうか
+            \param binary CSVファイルに加えてバイナリファイルにも出力するかどうか
+            \param tolerance CSVファイルの行を間引くときの相対誤差の許容値（0なら間引かない）
+        */
+        void saveresultbatch(std::int32_t n, MakeRhoEnergy::parameter_type const & pt, std::vector<double> const & Zlist, bool useomp, bool binary, double tolerance);
+
+        // #endregion 非メンバ関数
     }
 }
 
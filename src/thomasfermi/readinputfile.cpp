@@ -17,12 +17,16 @@
 */
 
 #include "readinputfile.h"
+#include <cmath>                        // for std::floor
 #include <iostream>                     // for std::cerr
+#include <iterator>                     // for std::back_inserter
 #include <stdexcept>                    // for std::runtime_error
 #include <utility>                      // for std::move
+#include <boost/algorithm/cxx11/all_of.hpp> // for boost::algorithm::all_of
+#include <boost/algorithm/cxx11/any_of.hpp> // for boost::algorithm::any_of
 #include <boost/assert.hpp>             // for BPOOST_ASSERT
 #include <boost/cast.hpp>               // for boost::numeric_cast
-#include <boost/range/algorithm.hpp>    // for boost::find, boost::transform
+#include <boost/range/algorithm.hpp>    // for boost::find, boost::max_element, boost::min_element, boost::transform
 #include <boost/tokenizer.hpp>          // for boost::tokenizer
 
 namespace thomasfermi {
@@ -94,6 +98,70 @@ namespace thomasfermi {
         
         // Iterationの収束判定条件の値を読み込む
         readValue("iteration.criterion", ITERATION_CRITERION_DEFAULT, pdata_->iteration_criterion_);
+
+        // 残りの行を、省略可能な要素として読み込む
+        if (!readOptionals()) {
+            errorendfunc();
+        }
+
+        // 解く模型を読み込む（省略可能）
+        if (!readModel()) {
+            errorendfunc();
+        }
+
+        // λWeizsäcker補正の係数を読み込む（省略可能）
+        if (!readWeizsackerLambda()) {
+            errorendfunc();
+        }
+
+        // イオンの電離度を読み込む（省略可能）
+        if (!readIonDegree()) {
+            errorendfunc();
+        }
+
+        // セルの質量密度を読み込む（省略可能）
+        if (!readCellDensity()) {
+            errorendfunc();
+        }
+
+        // 原子量を読み込む（セルの質量密度が与えられたときは必須）
+        if (!readAtomicMass()) {
+            errorendfunc();
+        }
+
+        // 温度を読み込む（省略可能）
+        if (!readTemperature()) {
+            errorendfunc();
+        }
+
+        // パラメータスイープする値のリストを読み込む（省略可能）
+        if (!readSweep()) {
+            errorendfunc();
+        }
+
+        // 計算結果をバイナリファイルにも出力するかどうかを読み込む（省略可能）
+        if (!readOutputBinary()) {
+            errorendfunc();
+        }
+
+        // CSVファイルの行を間引くときの許容誤差を読み込む（省略可能）
+        if (!readOutputTolerance()) {
+            errorendfunc();
+        }
+
+        // 反復の状態をチェックポイントファイルに書き出す間隔を読み込む（省略可能）
+        if (!readCheckpointInterval()) {
+            errorendfunc();
+        }
+
+        // 取り出されなかった行は未知の要素なので、黙って無視せずにエラーにする
+        if (!optionals_.empty()) {
+            for (auto const & [article, value] : optionals_) {
+                std::cerr << "インプットファイル" << value.first << "行目の[" << article.c_str() << "]は未知の要素です" << std::endl;
+            }
+
+            errorendfunc();
+        }
     }
     
     // #endregion publicメンバ関数
@@ -111,6 +179,68 @@ namespace thomasfermi {
         std::cerr << line << "行目, 未知のトークン:" << s2.c_str() << std::endl;
     }
 
+    std::optional< std::vector<double> > ReadInputFile::parseList(ci_string const & str) const
+    {
+        // 文字列全体を数値として読み込む
+        auto const tonumber = [](std::string const & s) {
+            std::size_t idx;
+            auto const v = std::stod(s, &idx);
+            if (idx != s.length()) {
+                throw std::invalid_argument("");
+            }
+
+            return v;
+        };
+
+        using boost_char_sep = boost::char_separator<char>;
+        using boost_tokenizer = boost::tokenizer<boost_char_sep>;
+
+        auto const strs = std::string(str.c_str());
+        boost_tokenizer tok(strs, boost_char_sep(","));
+
+        std::vector<double> list;
+        try {
+            for (auto && item : tok) {
+                // 範囲を表す「-」を探す（先頭の符号と、指数部の符号は除く）
+                auto pos = std::string::npos;
+                for (auto i = 1U; i < item.length(); i++) {
+                    if (item[i] == '-' && item[i - 1] != 'e' && item[i - 1] != 'E') {
+                        pos = i;
+                        break;
+                    }
+                }
+
+                if (pos == std::string::npos) {
+                    list.push_back(tonumber(item));
+                    continue;
+                }
+
+                // 刻み幅は「:」の後ろ（省略されたら1）
+                auto const colon = item.find(':', pos);
+                auto const first = tonumber(item.substr(0, pos));
+                auto const last = tonumber(item.substr(pos + 1, colon == std::string::npos ? std::string::npos : colon - pos - 1));
+                auto const step = colon == std::string::npos ? 1.0 : tonumber(item.substr(colon + 1));
+                if (first > last || step <= 0.0) {
+                    throw std::invalid_argument("");
+                }
+
+                auto const n = static_cast<std::int32_t>(std::floor((last - first) / step + 1.0E-9));
+                for (auto i = 0; i <= n; i++) {
+                    list.push_back(first + static_cast<double>(i) * step);
+                }
+            }
+        }
+        catch (std::exception const &) {
+            return std::nullopt;
+        }
+
+        if (list.empty()) {
+            return std::nullopt;
+        }
+
+        return std::make_optional(std::move(list));
+    }
+
     std::pair<std::int32_t, std::optional<ReadInputFile::strvec>> ReadInputFile::getToken(ci_string const & article)
     {
         std::array<char, BUFSIZE> buf;
@@ -164,10 +294,18 @@ namespace thomasfermi {
         if (!chemsym) {
             return false;
         }
-        else {
-            pdata_->Z_ = std::stod(std::string(chemsym->c_str()));
-            return true;
+
+        // 「1-92」のような範囲指定や、「1,6,26」のようなリストを展開する
+        auto const zlist(parseList(*chemsym));
+        if (!zlist || boost::algorithm::any_of(*zlist, [](auto z) { return z <= 0.0; })) {
+            errorMessage(lineindex_ - 1, ReadInputFile::CHEMICAL_NUMBER, *chemsym);
+            return false;
         }
+
+        pdata_->Zlist_ = *zlist;
+        pdata_->Z_ = pdata_->Zlist_.front();
+
+        return true;
     }
 
     std::optional<ci_string> ReadInputFile::readData(ci_string const & article)
@@ -320,6 +458,122 @@ namespace thomasfermi {
         }
     }
     
+    std::optional<ci_string> ReadInputFile::readDataOptional(ci_string const & article)
+    {
+        auto const itr = optionals_.find(article);
+        if (itr == optionals_.end()) {
+            // 省略された
+            return std::make_optional<ci_string>();
+        }
+
+        auto const tokens(std::move(itr->second.second));
+        lineindex_ = itr->second.first + 1;
+        optionals_.erase(itr);
+
+        if (tokens.size() == 1 || tokens[1] == "DEFAULT" || tokens[1][0] == '#') {
+            return std::make_optional<ci_string>();
+        }
+        else if (tokens.size() > 2 && tokens[2][0] != '#') {
+            errorMessage(lineindex_ - 1, article, tokens[2]);
+            return std::nullopt;
+        }
+
+        return std::make_optional<ci_string>(tokens[1]);
+    }
+
+    bool ReadInputFile::readOptionals()
+    {
+        using boost_char_sep = boost::char_separator<char>;
+        using boost_tokenizer = boost::tokenizer<boost_char_sep>;
+
+        for (; true; lineindex_++) {
+            std::array<char, BUFSIZE> buf;
+            ifs_.getline(buf.data(), BUFSIZE);
+
+            // ファイルの終わり
+            if (!ifs_.gcount()) {
+                ifs_.clear();
+                return true;
+            }
+
+            ci_string const line(buf.data());
+
+            // 空行とコメント行は読み飛ばす
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+
+            auto const strs = std::string(line.c_str());
+            boost_tokenizer tok(strs, boost_char_sep(" \r\t"));
+
+            strvec tokens;
+            boost::transform(
+                tok,
+                std::back_inserter(tokens),
+                [](auto && str) { return ci_string(str.c_str()); });
+
+            if (tokens.empty()) {
+                continue;
+            }
+
+            auto const article = tokens[0];
+            auto const [itr, inserted] = optionals_.try_emplace(article, lineindex_, std::move(tokens));
+            if (!inserted) {
+                std::cerr << "インプットファイル" << lineindex_ << "行目の[" << article.c_str() << "]は、"
+                          << itr->second.first << "行目と重複しています" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    bool ReadInputFile::readIonDegree()
+    {
+        auto const str(readDataOptional("ion.degree"));
+        if (!str) {
+            return false;
+        }
+
+        pdata_->ion_degree_.clear();
+        if (str->empty()) {
+            return true;
+        }
+
+        // 電離度は0 < q < 1でなければならない
+        auto const list(parseList(*str));
+        if (!list || boost::algorithm::any_of(*list, [](auto q) { return q <= 0.0 || q >= 1.0; })) {
+            errorMessage(lineindex_ - 1, "ion.degree", *str);
+            return false;
+        }
+
+        pdata_->ion_degree_ = *list;
+
+        return true;
+    }
+
+    bool ReadInputFile::readModel()
+    {
+        auto const str(readDataOptional("model"));
+        if (!str) {
+            return false;
+        }
+
+        if (str->empty() || *str == "TF") {
+            pdata_->model_ = Model::TF;
+        }
+        else if (*str == "TFD") {
+            pdata_->model_ = Model::TFD;
+        }
+        else if (*str == "TFW") {
+            pdata_->model_ = Model::TFW;
+        }
+        else {
+            errorMessage(lineindex_ - 1, "model", *str);
+            return false;
+        }
+
+        return true;
+    }
+
     bool ReadInputFile::readIterationMixingWeight()
     {
         readValue("iteration.Mixing.Weight", ITERATION_MIXING_WEIGHT_DEFAULT, pdata_->iteration_mixing_weight_);
@@ -340,6 +594,257 @@ namespace thomasfermi {
         return true;
     }
 
+    bool ReadInputFile::readWeizsackerLambda()
+    {
+        auto const str(readDataOptional("weizsacker.lambda"));
+        if (!str) {
+            return false;
+        }
+
+        if (str->empty()) {
+            pdata_->weizsacker_lambda_ = WEIZSACKER_LAMBDA_DEFAULT;
+            return true;
+        }
+
+        // 他の模型では使わないので、黙って無視せずにエラーにする
+        if (pdata_->model_ != Model::TFW) {
+            std::cerr << "インプットファイルの[weizsacker.lambda]は、model = TFWのときだけ使えます" << std::endl;
+            return false;
+        }
+
+        // λは正の値でなければならない
+        auto const list(parseList(*str));
+        if (!list || list->size() != 1 || list->front() <= 0.0) {
+            errorMessage(lineindex_ - 1, "weizsacker.lambda", *str);
+            return false;
+        }
+
+        pdata_->weizsacker_lambda_ = list->front();
+
+        return true;
+    }
+
+    bool ReadInputFile::readCellDensity()
+    {
+        auto const str(readDataOptional("cell.density"));
+        if (!str) {
+            return false;
+        }
+
+        pdata_->cell_density_.clear();
+        if (str->empty()) {
+            return true;
+        }
+
+        // 質量密度は正の値でなければならない
+        auto const list(parseList(*str));
+        if (!list || boost::algorithm::any_of(*list, [](auto rho) { return rho <= 0.0; })) {
+            errorMessage(lineindex_ - 1, "cell.density", *str);
+            return false;
+        }
+
+        pdata_->cell_density_ = *list;
+
+        return true;
+    }
+
+    bool ReadInputFile::readAtomicMass()
+    {
+        auto const str(readDataOptional("atomic.mass"));
+        if (!str) {
+            return false;
+        }
+
+        if (str->empty()) {
+            if (!pdata_->cell_density_.empty()) {
+                errorMessage("atomic.mass");
+                return false;
+            }
+
+            return true;
+        }
+
+        // 原子量は正の値でなければならない
+        auto const list(parseList(*str));
+        if (!list || list->size() != 1 || list->front() <= 0.0) {
+            errorMessage(lineindex_ - 1, "atomic.mass", *str);
+            return false;
+        }
+
+        pdata_->atomic_mass_ = list->front();
+
+        return true;
+    }
+
+    bool ReadInputFile::readTemperature()
+    {
+        auto const str(readDataOptional("temperature"));
+        if (!str) {
+            return false;
+        }
+
+        pdata_->temperature_.clear();
+        if (str->empty()) {
+            // 絶対零度でも、セルに閉じ込めた原子はThomas-Fermi模型でだけ解ける
+            if (pdata_->model_ != Model::TF && !pdata_->cell_density_.empty()) {
+                std::cerr << "インプットファイルの[cell.density]は、model = TFのときだけ使えます" << std::endl;
+                return false;
+            }
+
+            return true;
+        }
+
+        // 温度は正の値でなければならない
+        auto const list(parseList(*str));
+        if (!list || boost::algorithm::any_of(*list, [](auto T) { return T <= 0.0; })) {
+            errorMessage(lineindex_ - 1, "temperature", *str);
+            return false;
+        }
+
+        // 有限温度の原子は、Thomas-Fermi模型でセルに閉じ込めたときだけ解ける
+        if (pdata_->model_ != Model::TF || pdata_->cell_density_.empty()) {
+            std::cerr << "インプットファイルの[temperature]は、model = TFでcell.densityを指定したときだけ使えます" << std::endl;
+            return false;
+        }
+
+        pdata_->temperature_ = *list;
+
+        return true;
+    }
+
+    bool ReadInputFile::readSweep()
+    {
+        // 一つの要素を読み込んで、省略されていなければリストを返す（省略されたら空のリスト）
+        auto const readlist = [this](ci_string const & article, std::vector<double> & value, auto && isvalid) {
+            auto const str(readDataOptional(article));
+            if (!str) {
+                return false;
+            }
+
+            value.clear();
+            if (str->empty()) {
+                return true;
+            }
+
+            auto const list(parseList(*str));
+            if (!list || !boost::algorithm::all_of(*list, isvalid)) {
+                errorMessage(lineindex_ - 1, article, *str);
+                return false;
+            }
+
+            value = *list;
+
+            return true;
+        };
+
+        // メッシュの数は正の整数、重みは(0, 1]でなければならない
+        if (!readlist("sweep.grid.num", pdata_->sweep_grid_num_, [](auto n) { return n >= 1.0 && n == std::floor(n); }) ||
+            !readlist("sweep.grid.xmax", pdata_->sweep_xmax_, [this](auto x) { return x > pdata_->xmin_; }) ||
+            !readlist("sweep.matching.point", pdata_->sweep_match_point_, [this](auto x) { return x > pdata_->xmin_; }) ||
+            !readlist("sweep.iteration.Mixing.Weight", pdata_->sweep_mixing_weight_, [](auto w) { return w > 0.0 && w <= 1.0; })) {
+            return false;
+        }
+
+        if (pdata_->sweep_grid_num_.empty() && pdata_->sweep_xmax_.empty() &&
+            pdata_->sweep_match_point_.empty() && pdata_->sweep_mixing_weight_.empty()) {
+            return true;
+        }
+
+        // パラメータスイープは、孤立した中性原子のThomas-Fermi模型でだけ使える
+        if (pdata_->model_ != Model::TF || !pdata_->ion_degree_.empty() || !pdata_->cell_density_.empty()) {
+            std::cerr << "インプットファイルの[sweep]の行は、model = TFの孤立した中性原子でだけ使えます" << std::endl;
+            return false;
+        }
+
+        // 省略されたものは、通常の要素の値だけのリストにする
+        auto const fill = [](std::vector<double> & value, double def) {
+            if (value.empty()) {
+                value.push_back(def);
+            }
+        };
+
+        fill(pdata_->sweep_grid_num_, static_cast<double>(pdata_->grid_num_));
+        fill(pdata_->sweep_xmax_, pdata_->xmax_);
+        fill(pdata_->sweep_match_point_, pdata_->match_point_);
+        fill(pdata_->sweep_mixing_weight_, pdata_->iteration_mixing_weight_);
+
+        // マッチングポイントは、どのメッシュの最大値よりも小さくなければならない
+        if (*boost::max_element(pdata_->sweep_match_point_) >= *boost::min_element(pdata_->sweep_xmax_)) {
+            std::cerr << "インプットファイルの[sweep.matching.point]の行が正しくありません" << std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReadInputFile::readOutputBinary()
+    {
+        auto const str(readDataOptional("output.binary"));
+        if (!str) {
+            return false;
+        }
+
+        if (str->empty() || *str == "false") {
+            pdata_->output_binary_ = false;
+        }
+        else if (*str == "true") {
+            pdata_->output_binary_ = true;
+        }
+        else {
+            errorMessage(lineindex_ - 1, "output.binary", *str);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReadInputFile::readOutputTolerance()
+    {
+        auto const str(readDataOptional("output.tolerance"));
+        if (!str) {
+            return false;
+        }
+
+        if (str->empty()) {
+            pdata_->output_tolerance_ = 0.0;
+            return true;
+        }
+
+        // 許容誤差は正の値でなければならない
+        auto const list(parseList(*str));
+        if (!list || list->size() != 1 || list->front() <= 0.0) {
+            errorMessage(lineindex_ - 1, "output.tolerance", *str);
+            return false;
+        }
+
+        pdata_->output_tolerance_ = list->front();
+
+        return true;
+    }
+
+    bool ReadInputFile::readCheckpointInterval()
+    {
+        auto const str(readDataOptional("checkpoint.interval"));
+        if (!str) {
+            return false;
+        }
+
+        if (str->empty()) {
+            pdata_->checkpoint_interval_ = 0;
+            return true;
+        }
+
+        // 間隔は正の整数でなければならない
+        auto const list(parseList(*str));
+        if (!list || list->size() != 1 || list->front() < 1.0 || list->front() != std::floor(list->front())) {
+            errorMessage(lineindex_ - 1, "checkpoint.interval", *str);
+            return false;
+        }
+
+        pdata_->checkpoint_interval_ = static_cast<std::uint32_t>(list->front());
+
+        return true;
+    }
     
     // #endregion privateメンバ関数
 }
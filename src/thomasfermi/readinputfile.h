@@ -25,6 +25,7 @@
 #include "data.h"
 #include "utility/property.h"
 #include <fstream>                  // for std::ifstream
+#include <map>                      // for std::map
 #include <memory>                   // for std::shared_ptr
 #include <optional>                 // for std::optional
 #include <vector>                   // for std::vector
@@ -94,6 +95,14 @@ namespace thomasfermi {
         */
         std::pair< std::int32_t, std::optional<ReadInputFile::strvec> > getToken(ci_string const & article);
 
+        //! A private member function (const).
+        /*!
+            「1,6,26」のようなリストや、「1-92」、「0.1-0.9:0.1」のような範囲指定を展開する
+            \param str 解析対象の文字列
+            \return 展開した数値のリスト（解析に失敗したらstd::nullopt）
+        */
+        std::optional< std::vector<double> > parseList(ci_string const & str) const;
+
         //! A private member function.
         /*!
             原子に関するデータを読み込む
@@ -136,6 +145,23 @@ namespace thomasfermi {
         */
         std::optional<ci_string> readDataAuto(ci_string const & article);
 
+        //! A private member function.
+        /*!
+            省略可能な要素のデータを、readOptionals()で読み込んだ行から取り出す
+            取り出した行の次の行を現在の行数にする（エラーメッセージの行数を合わせるため）
+            \param article 解析対象の文字列
+            \return 読みこんだ文字列（省略されていたら空文字列、読み込みに失敗したらstd::nullopt）
+        */
+        std::optional<ci_string> readDataOptional(ci_string const & article);
+
+        //! A private member function.
+        /*!
+            必須の要素の後ろの行を、すべて要素の名前ごとに読み込む
+            省略可能な要素は、どの順序で書いてもよい
+            \return 読み込みが成功したかどうか（同じ要素が二度現れたら失敗）
+        */
+        bool readOptionals();
+
         //! A private member function.
         /*!
             マッチングポイントの値を読み込む
@@ -150,6 +176,77 @@ namespace thomasfermi {
         */
         bool readIterationMixingWeight();
 
+        //! A private member function.
+        /*!
+            イオンの電離度のリストを読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readIonDegree();
+
+        //! A private member function.
+        /*!
+            解く模型を読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readModel();
+
+        //! A private member function.
+        /*!
+            λWeizsäcker補正の係数λを読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readWeizsackerLambda();
+
+        //! A private member function.
+        /*!
+            セルの質量密度のリストを読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readCellDensity();
+
+        //! A private member function.
+        /*!
+            原子量を読み込む（セルの質量密度が与えられたときは必須）
+            \return 読み込みが成功したかどうか
+        */
+        bool readAtomicMass();
+
+        //! A private member function.
+        /*!
+            温度のリストを読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readTemperature();
+
+        //! A private member function.
+        /*!
+            パラメータスイープする値のリストを読み込む（省略可能）
+            一つでも指定されたら、省略されたものは単一の値のリストにする
+            \return 読み込みが成功したかどうか
+        */
+        bool readSweep();
+
+        //! A private member function.
+        /*!
+            計算結果をバイナリファイルにも出力するかどうかを読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readOutputBinary();
+
+        //! A private member function.
+        /*!
+            CSVファイルの行を間引くときの相対誤差の許容値を読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readOutputTolerance();
+
+        //! A private member function.
+        /*!
+            反復の状態をチェックポイントファイルに書き出す間隔を読み込む（省略可能）
+            \return 読み込みが成功したかどうか
+        */
+        bool readCheckpointInterval();
+
         template <typename T>
         //! A private member function.
         /*!
@@ -211,6 +308,12 @@ namespace thomasfermi {
         */
         std::size_t lineindex_;
 
+        //! A private member variable.
+        /*!
+            まだ取り出していない省略可能な要素の行（要素の名前から、行数とトークンへのmap）
+        */
+        std::map< ci_string, std::pair<std::size_t, strvec> > optionals_;
+
         //! A private member variable.
         /*!
             インプットファイルから読み込んだデータ
@@ -271,7 +374,7 @@ namespace thomasfermi {
                     break;
 
                 case 2:
-                    if (*(++itr) == "DEFAULT") {
+                    if (*itr == "DEFAULT") {
                         // デフォルト値を返す
                         return std::make_optional<T>(default_value);
                     }
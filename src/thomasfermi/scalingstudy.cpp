@@ -0,0 +1,177 @@
+﻿/*! \file scalingstudy.cpp
+    \brief メッシュの分割数とスレッド数を変えて標準の問題を解き、性能を表にまとめるクラスの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../checkpoint/checkpoint.h"
+#include "iteration.h"
+#include "makerhoen/makerhoenergy.h"
+#include "scalingstudy.h"
+#include <array>                // for std::array
+#include <cmath>                // for std::fabs
+#include <cstdio>               // for FILE, std::fclose, std::fopen, std::fprintf
+#include <iostream>             // for std::cout
+#include <memory>               // for std::make_shared, std::unique_ptr
+#include <stdexcept>            // for std::runtime_error
+#include <tuple>                // for std::get
+#include <boost/format.hpp>     // for boost::format
+#include <omp.h>                // for omp_get_max_threads, omp_set_num_threads
+
+namespace thomasfermi {
+    // #region コンストラクタ
+
+    ScalingStudy::ScalingStudy(std::uint32_t maxgrid)
+        :   maxgrid_(maxgrid)
+    {
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    void ScalingStudy::run(std::string const & filename)
+    {
+        // スレッド数を変える前に、最大のスレッド数を調べておく
+        auto const maxthreads = omp_get_max_threads();
+
+        std::vector<std::int32_t> threads;
+        for (auto t = 1; t < maxthreads; t *= 2) {
+            threads.push_back(t);
+        }
+        threads.push_back(maxthreads);
+
+        for (auto grid = 1000U; grid <= maxgrid_; grid *= 10U) {
+            for (auto const t : threads) {
+                auto const & r = result_.emplace_back(solve(grid, t));
+
+                std::cout << boost::format("grid.num = %d, threads = %d, %s, iteration = %d, time = %.4f + %.4f + %.4f (msec), peak = %d (kB), energy error = %.3e\n")
+                    % r.grid % r.threads % (r.converged ? "converged" : "failed") % r.iteration
+                    % r.initialize % r.loop % r.energy % r.peakmem % std::fabs((r.E - ScalingStudy::ENERGY_REFERENCE) / ScalingStudy::ENERGY_REFERENCE)
+                    << std::flush;
+            }
+
+            // 10倍したときに桁あふれするなら終わり
+            if (grid > maxgrid_ / 10U) {
+                break;
+            }
+        }
+
+        auto const json = filename.size() >= 5 && filename.compare(filename.size() - 5, 5, ".json") == 0;
+        if (json) {
+            savejson(filename);
+        }
+        else {
+            savecsv(filename);
+        }
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    ScalingStudy::Result ScalingStudy::solve(std::uint32_t grid, std::int32_t threads)
+    {
+        omp_set_num_threads(threads);
+
+        auto const pdata = std::make_shared<Data>();
+        pdata->grid_num_ = grid;
+        pdata->useomp_ = threads > 1;
+
+        Result r = {};
+        r.grid = grid;
+        r.threads = threads;
+
+        // 前の組み合わせの最大メモリ使用量を持ち越さない
+        checkpoint::resetpeakmem();
+
+        checkpoint::CheckPoint cp;
+        cp.checkpoint("処理開始", __LINE__);
+
+        try {
+            femall::Iteration iter(pdata);
+            cp.checkpoint("初期関数生成処理", __LINE__);
+
+            r.iteration = iter.Iterationloop(false);
+            cp.checkpoint("Iterationループ処理", __LINE__);
+
+            auto const result = iter.makeresult();
+            makerhoen::MakeRhoEnergy const mre(pdata->gauss_legendre_integ_, result, 1.0, pdata->useomp_);
+            r.E = mre.makeenergy();
+            r.yprime0 = std::get<2>(result);
+            cp.checkpoint("エネルギー計算処理", __LINE__);
+
+            r.converged = true;
+        }
+        catch (std::runtime_error const &) {
+            // 収束しなかった組み合わせも、そこまでの時間を記録する
+            cp.checkpoint("失敗", __LINE__);
+        }
+
+        r.peakmem = checkpoint::peakmem();
+
+        auto const elapsed = cp.elapsed();
+        std::array<double *, 3> const phase = { &r.initialize, &r.loop, &r.energy };
+        for (auto i = 0U; i < elapsed.size() && i < phase.size(); i++) {
+            *phase[i] = elapsed[i].second;
+        }
+
+        return r;
+    }
+
+    void ScalingStudy::savecsv(std::string const & filename) const
+    {
+        std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(filename.c_str(), "w"), std::fclose);
+        if (!fp) {
+            throw std::runtime_error("ファイルが開けませんでした。");
+        }
+
+        std::fprintf(fp.get(), "grid,threads,converged,iteration,initialize_ms,iteration_ms,energy_ms,total_ms,ms_per_iteration,peak_rss_kb,energy,energy_error,yprime0,yprime0_error\n");
+        for (auto const & r : result_) {
+            auto const total = r.initialize + r.loop + r.energy;
+            std::fprintf(fp.get(), "%u,%d,%d,%u,%.6f,%.6f,%.6f,%.6f,%.6f,%zu,%.15f,%.6e,%.15f,%.6e\n",
+                r.grid, r.threads, r.converged ? 1 : 0, r.iteration, r.initialize, r.loop, r.energy, total,
+                r.iteration ? r.loop / r.iteration : 0.0, r.peakmem,
+                r.E, std::fabs((r.E - ScalingStudy::ENERGY_REFERENCE) / ScalingStudy::ENERGY_REFERENCE),
+                r.yprime0, std::fabs((r.yprime0 - ScalingStudy::YPRIME0_REFERENCE) / ScalingStudy::YPRIME0_REFERENCE));
+        }
+    }
+
+    void ScalingStudy::savejson(std::string const & filename) const
+    {
+        std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(filename.c_str(), "w"), std::fclose);
+        if (!fp) {
+            throw std::runtime_error("ファイルが開けませんでした。");
+        }
+
+        std::fprintf(fp.get(), "{\n  \"energy_reference\": %.16f,\n  \"yprime0_reference\": %.16f,\n  \"runs\": [",
+            ScalingStudy::ENERGY_REFERENCE, ScalingStudy::YPRIME0_REFERENCE);
+
+        for (auto i = 0U; i < result_.size(); i++) {
+            auto const & r = result_[i];
+            std::fprintf(fp.get(), "%s\n    {\"grid\": %u, \"threads\": %d, \"converged\": %s, \"iteration\": %u, "
+                "\"initialize_ms\": %.6f, \"iteration_ms\": %.6f, \"energy_ms\": %.6f, \"total_ms\": %.6f, \"peak_rss_kb\": %zu, "
+                "\"energy\": %.15f, \"energy_error\": %.6e, \"yprime0\": %.15f, \"yprime0_error\": %.6e}",
+                i ? "," : "", r.grid, r.threads, r.converged ? "true" : "false", r.iteration,
+                r.initialize, r.loop, r.energy, r.initialize + r.loop + r.energy, r.peakmem,
+                r.E, std::fabs((r.E - ScalingStudy::ENERGY_REFERENCE) / ScalingStudy::ENERGY_REFERENCE),
+                r.yprime0, std::fabs((r.yprime0 - ScalingStudy::YPRIME0_REFERENCE) / ScalingStudy::YPRIME0_REFERENCE));
+        }
+
+        std::fprintf(fp.get(), "\n  ]\n}\n");
+    }
+
+    // #endregion privateメンバ関数
+}
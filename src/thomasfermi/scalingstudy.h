@@ -0,0 +1,168 @@
+﻿/*! \file scalingstudy.h
+    \brief メッシュの分割数とスレッド数を変えて標準の問題を解き、性能を表にまとめるクラスの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SCALINGSTUDY_H_
+#define _SCALINGSTUDY_H_
+
+#pragma once
+
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::int32_t, std::uint32_t
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+namespace thomasfermi {
+    //! A class.
+    /*!
+        標準の問題（インプットファイルのデフォルト値の中性原子）を、メッシュの分割数とスレッド数を変えて解き、
+        段階ごとの時間、収束までの反復回数、最大メモリ使用量、エネルギーの誤差を一つの表にまとめるクラス
+        メッシュの分割数は1000から最大値まで10倍ずつ、スレッド数は1から最大のスレッド数まで2倍ずつ（最大値も含む）変える
+        段階ごとの時間はcheckpoint::CheckPointで計測する
+    */
+    class ScalingStudy final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param maxgrid メッシュの分割数の最大値
+        */
+        explicit ScalingStudy(std::uint32_t maxgrid);
+
+        //! A default destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~ScalingStudy() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function.
+        /*!
+            すべての組み合わせを解いて、結果をファイルに書き込む
+            \param filename ファイル名（拡張子が.jsonならJSON形式、それ以外はCSV形式）
+        */
+        void run(std::string const & filename);
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A struct.
+        /*!
+            一つの組み合わせの結果
+        */
+        struct Result final {
+            std::uint32_t grid;         //!< メッシュの分割数
+            std::int32_t threads;       //!< スレッド数
+            bool converged;             //!< 収束したかどうか
+            std::uint32_t iteration;    //!< 収束までの反復回数
+            double initialize;          //!< 初期関数生成の時間（msec）
+            double loop;                //!< 反復の時間（msec）
+            double energy;              //!< エネルギーの計算の時間（msec）
+            std::size_t peakmem;        //!< 最大メモリ使用量（kB）
+            double E;                   //!< エネルギー（Z = 1、Hartree）
+            double yprime0;             //!< y'(0)
+        };
+
+        //! A private member function.
+        /*!
+            一つの組み合わせを解く
+            \param grid メッシュの分割数
+            \param threads スレッド数
+            \return 結果
+        */
+        Result solve(std::uint32_t grid, std::int32_t threads);
+
+        //! A private member function (const).
+        /*!
+            結果をCSV形式で書き込む
+            \param filename ファイル名
+        */
+        void savecsv(std::string const & filename) const;
+
+        //! A private member function (const).
+        /*!
+            結果をJSON形式で書き込む
+            \param filename ファイル名
+        */
+        void savejson(std::string const & filename) const;
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant expression).
+        /*!
+            y'(0)の高精度な参照値
+        */
+        static auto constexpr YPRIME0_REFERENCE = -1.588071022611375;
+
+        //! A private member variable (constant expression).
+        /*!
+            エネルギーの高精度な参照値（E = 3 / 7 * y'(0) / b * Z^(7/3)、b = (9π^2 / 128)^(1/3)、Z = 1）
+        */
+        static auto constexpr ENERGY_REFERENCE = -0.7687451242136615;
+
+        //! A private member variable.
+        /*!
+            メッシュの分割数の最大値
+        */
+        std::uint32_t const maxgrid_;
+
+        //! A private member variable.
+        /*!
+            結果
+        */
+        std::vector<Result> result_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        ScalingStudy() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        ScalingStudy(ScalingStudy const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        ScalingStudy & operator=(ScalingStudy const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SCALINGSTUDY_H_
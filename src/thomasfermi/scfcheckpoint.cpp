@@ -0,0 +1,157 @@
+﻿/*! \file scfcheckpoint.cpp
+    \brief 反復の状態をチェックポイントファイルに書き出し、また読み込むクラスの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scfcheckpoint.h"
+#include <cstdio>       // for FILE, std::fclose, std::fflush, std::fopen, std::fread, std::fwrite, std::rename
+#include <cstring>      // for std::memcpy
+#include <iostream>     // for std::cerr
+#include <memory>       // for std::unique_ptr
+#include <stdexcept>    // for std::runtime_error
+#include <utility>      // for std::move
+
+#ifdef _WIN32
+    #include <windows.h>    // for MoveFileExA
+#else
+    #include <unistd.h>     // for fsync
+#endif
+
+namespace thomasfermi {
+    namespace femall {
+        // #region コンストラクタ・デストラクタ
+
+        ScfCheckpoint::ScfCheckpoint(std::string const & filename)
+            :   filename_(filename)
+        {
+        }
+
+        ScfCheckpoint::~ScfCheckpoint()
+        {
+            wait();
+        }
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        std::uint64_t ScfCheckpoint::makehash(Data const & data) noexcept
+        {
+            // FNV-1a
+            auto hash = 14695981039346656037ULL;
+            auto const append = [&hash](auto value) {
+                unsigned char bytes[sizeof(value)];
+                std::memcpy(bytes, &value, sizeof(value));
+                for (auto const b : bytes) {
+                    hash = (hash ^ b) * 1099511628211ULL;
+                }
+            };
+
+            append(data.eps_);
+            append(data.gauss_legendre_integ_);
+            append(data.grid_num_);
+            append(data.iteration_mixing_weight_);
+            append(data.match_point_);
+            append(data.xmax_);
+            append(data.xmin_);
+
+            return hash;
+        }
+
+        ScfCheckpoint::State ScfCheckpoint::load(std::string const & filename)
+        {
+            std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(filename.c_str(), "rb"), std::fclose);
+            if (!fp) {
+                throw std::runtime_error("チェックポイントファイルが開けませんでした。");
+            }
+
+            Header header;
+            if (std::fread(&header, sizeof(Header), 1, fp.get()) != 1 ||
+                header.magic != ScfCheckpoint::MAGIC || header.version != ScfCheckpoint::VERSION) {
+                throw std::runtime_error("チェックポイントファイルではありません。");
+            }
+
+            State state = { header.hash, header.iter, header.y1, header.y2, std::vector<double>(header.size) };
+            if (std::fread(state.y.data(), sizeof(double), state.y.size(), fp.get()) != state.y.size()) {
+                throw std::runtime_error("チェックポイントファイルが壊れています。");
+            }
+
+            return state;
+        }
+
+        void ScfCheckpoint::save(State && state)
+        {
+            wait();
+
+            pending_ = std::async(std::launch::async, [this, state = std::move(state)] {
+                ScfCheckpoint::write(filename_, state);
+            });
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+        void ScfCheckpoint::wait() noexcept
+        {
+            if (!pending_.valid()) {
+                return;
+            }
+
+            try {
+                pending_.get();
+            }
+            catch (std::runtime_error const & e) {
+                // チェックポイントが書けなくても、反復は続ける
+                std::cerr << e.what() << std::endl;
+            }
+        }
+
+        void ScfCheckpoint::write(std::string const & filename, State const & state)
+        {
+            auto const tmpname = filename + ".tmp";
+
+            {
+                std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen(tmpname.c_str(), "wb"), std::fclose);
+                if (!fp) {
+                    throw std::runtime_error("チェックポイントファイルが書き込めませんでした。");
+                }
+
+                Header const header = { ScfCheckpoint::MAGIC, ScfCheckpoint::VERSION, state.iter, state.hash, state.y.size(), state.y1, state.y2 };
+                std::fwrite(&header, sizeof(Header), 1, fp.get());
+                std::fwrite(state.y.data(), sizeof(double), state.y.size(), fp.get());
+
+                // 置き換える前に、ディスクまで書き出しておく
+                if (std::fflush(fp.get()) || std::ferror(fp.get())) {
+                    throw std::runtime_error("チェックポイントファイルが書き込めませんでした。");
+                }
+#ifndef _WIN32
+                fsync(fileno(fp.get()));
+#endif
+            }
+
+#ifdef _WIN32
+            if (!MoveFileExA(tmpname.c_str(), filename.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+#else
+            if (std::rename(tmpname.c_str(), filename.c_str())) {
+#endif
+                throw std::runtime_error("チェックポイントファイルが置き換えられませんでした。");
+            }
+        }
+
+        // #endregion privateメンバ関数
+    }
+}
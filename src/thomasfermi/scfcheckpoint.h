@@ -0,0 +1,226 @@
+﻿/*! \file scfcheckpoint.h
+    \brief 反復の状態をチェックポイントファイルに書き出し、また読み込むクラスの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SCFCHECKPOINT_H_
+#define _SCFCHECKPOINT_H_
+
+#pragma once
+
+#include "data.h"
+#include <array>        // for std::array
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <future>       // for std::future
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+namespace thomasfermi {
+    namespace femall {
+        //! A class.
+        /*!
+            Iterationの反復の状態をチェックポイントファイルに書き出し、また読み込むクラス
+            一時ファイルに書いてからrenameで置き換えるので、書き込みの途中で止まっても前のファイルは壊れない
+            書き込みは別のスレッドで行い、反復を止めない（前の書き込みが終わっていなければ、それを待つ）
+        */
+        class ScfCheckpoint final {
+            // #region 型
+
+        public:
+            //! A struct.
+            /*!
+                反復の状態
+                一次混合のYoldは次の反復の始めにyで上書きされるので、yだけで反復を再開できる
+            */
+            struct State final {
+                //! A public member variable.
+                /*!
+                    計算条件のハッシュ値（makehash()）
+                */
+                std::uint64_t hash;
+
+                //! A public member variable.
+                /*!
+                    終わった反復の回数
+                */
+                std::uint32_t iter;
+
+                //! A public member variable.
+                /*!
+                    yの境界条件（原点に近い方）
+                */
+                double y1;
+
+                //! A public member variable.
+                /*!
+                    yの境界条件（原点から遠い方）
+                */
+                double y2;
+
+                //! A public member variable.
+                /*!
+                    混合した後のy
+                */
+                std::vector<double> y;
+            };
+
+            // #endregion 型
+
+            // #region コンストラクタ・デストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param filename チェックポイントファイル名
+            */
+            explicit ScfCheckpoint(std::string const & filename);
+
+            //! A destructor.
+            /*!
+                デストラクタ
+                書き込み中なら、書き終わるのを待つ
+            */
+            ~ScfCheckpoint();
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region publicメンバ関数
+
+            //! A public static member function.
+            /*!
+                反復の軌跡を決める計算条件から、ハッシュ値を求める
+                （収束判定条件と最大ループ回数は含めないので、変えて再開できる）
+                \param data 計算条件
+                \return ハッシュ値
+            */
+            static std::uint64_t makehash(Data const & data) noexcept;
+
+            //! A public static member function.
+            /*!
+                チェックポイントファイルを読み込む
+                \param filename チェックポイントファイル名
+                \return 反復の状態
+            */
+            static State load(std::string const & filename);
+
+            //! A public member function.
+            /*!
+                反復の状態を、別のスレッドでチェックポイントファイルに書き出す
+                \param state 反復の状態
+            */
+            void save(State && state);
+
+            // #endregion publicメンバ関数
+
+            // #region privateメンバ関数
+
+        private:
+            //! A private member function.
+            /*!
+                書き込み中なら、書き終わるのを待つ（書き込めなかったときは警告を表示して続ける）
+            */
+            void wait() noexcept;
+
+            //! A private static member function.
+            /*!
+                反復の状態を一時ファイルに書き、チェックポイントファイルと置き換える
+                \param filename チェックポイントファイル名
+                \param state 反復の状態
+            */
+            static void write(std::string const & filename, State const & state);
+
+            // #endregion privateメンバ関数
+
+            // #region メンバ変数
+
+        public:
+            //! A public static member variable (constant expression).
+            /*!
+                チェックポイントファイル名
+            */
+            static auto constexpr FILENAME = "scf.chk";
+
+        private:
+            //! A struct.
+            /*!
+                チェックポイントファイルの先頭に置くヘッダ（この後にsize個のdoubleのyが続く）
+            */
+            struct Header final {
+                std::array<char, 8> magic;  //!< ファイルの先頭の識別子（MAGIC）
+                std::uint32_t version;      //!< 形式のバージョン（VERSION）
+                std::uint32_t iter;         //!< 終わった反復の回数
+                std::uint64_t hash;         //!< 計算条件のハッシュ値
+                std::uint64_t size;         //!< yの要素数
+                double y1;                  //!< yの境界条件（原点に近い方）
+                double y2;                  //!< yの境界条件（原点から遠い方）
+            };
+
+            //! A private static member variable (constant expression).
+            /*!
+                ファイルの先頭の識別子
+            */
+            static std::array<char, 8> constexpr MAGIC = { 'T', 'F', 'S', 'C', 'F', 'C', 'H', 'K' };
+
+            //! A private static member variable (constant expression).
+            /*!
+                形式のバージョン
+            */
+            static std::uint32_t constexpr VERSION = 1U;
+
+            //! A private member variable (constant).
+            /*!
+                チェックポイントファイル名
+            */
+            std::string const filename_;
+
+            //! A private member variable.
+            /*!
+                書き込み中のスレッドの結果
+            */
+            std::future<void> pending_;
+
+            // #endregion メンバ変数
+
+            // #region 禁止されたコンストラクタ・メンバ関数
+
+        public:
+            //! A default constructor (deleted).
+            /*!
+                デフォルトコンストラクタ（禁止）
+            */
+            ScfCheckpoint() = delete;
+
+            //! A copy constructor (deleted).
+            /*!
+                コピーコンストラクタ（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+            */
+            ScfCheckpoint(ScfCheckpoint const & dummy) = delete;
+
+            //! A public member function (deleted).
+            /*!
+                operator=()の宣言（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+                \return コピー元のオブジェクト
+            */
+            ScfCheckpoint & operator=(ScfCheckpoint const & dummy) = delete;
+
+            // #endregion 禁止されたコンストラクタ・メンバ関数
+        };
+    }
+}
+
+#endif  // _SCFCHECKPOINT_H_
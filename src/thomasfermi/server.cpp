@@ -0,0 +1,362 @@
+﻿/*! \file server.cpp
+    \brief ジョブを受け付けて、Thomas-Fermi方程式を解き続けるサーバーの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ci_string.h"
+#include "server.h"
+#include "utility/csvwriter.h"
+#include "utility/decimator.h"
+#include "utility/resultwriter.h"
+#include <algorithm>                            // for std::find_if, std::min, std::transform
+#include <array>                                // for std::array
+#include <cmath>                                // for std::cbrt
+#include <cstring>                              // for std::strcpy
+#include <iostream>                             // for std::cout
+#include <new>                                  // for std::bad_alloc
+#include <sstream>                              // for std::istringstream
+#include <stdexcept>                            // for std::invalid_argument, std::runtime_error
+#include <type_traits>                          // for std::remove_reference_t
+#include <boost/lexical_cast.hpp>               // for boost::lexical_cast
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+#ifndef _WIN32
+    #include <csignal>                          // for std::signal
+    #include <sys/socket.h>                     // for accept, bind, listen, socket
+    #include <sys/un.h>                         // for sockaddr_un
+    #include <unistd.h>                         // for close, dup, unlink
+#endif
+
+namespace thomasfermi {
+    // #region コンストラクタ
+
+    Server::Server(bool useomp)
+        :   useomp_(useomp)
+    {
+    }
+
+    // #endregion コンストラクタ
+
+    // #region publicメンバ関数
+
+    void Server::run(std::string const & path)
+    {
+        if (path == "-") {
+            session(stdin, stdout);
+            return;
+        }
+
+#ifdef _WIN32
+        throw std::runtime_error("UNIXドメインソケットは、Windowsでは使えません。");
+#else
+        sockaddr_un addr = {};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) {
+            throw std::runtime_error("ソケットのパスが長すぎます。");
+        }
+        std::strcpy(addr.sun_path, path.c_str());
+
+        auto const fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw std::runtime_error("ソケットを作れませんでした。");
+        }
+
+        unlink(path.c_str());
+        if (bind(fd, reinterpret_cast<sockaddr const *>(&addr), sizeof(addr)) < 0 || listen(fd, SOMAXCONN) < 0) {
+            close(fd);
+            throw std::runtime_error("ソケットで待ち受けられませんでした。");
+        }
+
+        // 応答を書き込む前に接続を切られても、プロセスを終わらせない
+        std::signal(SIGPIPE, SIG_IGN);
+
+        std::cout << path << "でジョブを待ち受けています。" << std::endl;
+
+        // 接続は一つずつ順に処理する（ソルバーの中でOpenMPで並列化する）
+        for (auto running = true; running;) {
+            auto const cfd = accept(fd, nullptr, nullptr);
+            if (cfd < 0) {
+                continue;
+            }
+
+            // 一つのFILEで読み書きを交互に行うにはfseekが要るので、読み込みと書き込みを別々のFILEにする
+            std::unique_ptr<FILE, decltype(&std::fclose)> in(fdopen(cfd, "r"), std::fclose);
+            if (!in) {
+                close(cfd);
+                continue;
+            }
+
+            auto const wfd = dup(cfd);
+            std::unique_ptr<FILE, decltype(&std::fclose)> out(wfd < 0 ? nullptr : fdopen(wfd, "w"), std::fclose);
+            if (!out) {
+                if (wfd >= 0) {
+                    close(wfd);
+                }
+                continue;
+            }
+
+            running = session(in.get(), out.get());
+        }
+
+        close(fd);
+        unlink(path.c_str());
+#endif
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    bool Server::issame(Data const & lhs, Data const & rhs) noexcept
+    {
+        return lhs.eps_ == rhs.eps_ &&
+               lhs.gauss_legendre_integ_ == rhs.gauss_legendre_integ_ &&
+               lhs.grid_num_ == rhs.grid_num_ &&
+               lhs.iteration_criterion_ == rhs.iteration_criterion_ &&
+               lhs.iteration_maxiter_ == rhs.iteration_maxiter_ &&
+               lhs.iteration_mixing_weight_ == rhs.iteration_mixing_weight_ &&
+               lhs.match_point_ == rhs.match_point_ &&
+               lhs.xmax_ == rhs.xmax_ &&
+               lhs.xmin_ == rhs.xmin_;
+    }
+
+    std::shared_ptr<Data> Server::parse(std::vector<std::string> const & lines) const
+    {
+        auto const pdata = std::make_shared<Data>();
+        pdata->useomp_ = useomp_;
+        pdata->Z_ = 0.0;
+
+        for (auto const & line : lines) {
+            std::istringstream iss(line);
+            std::string k, v, rest;
+            iss >> k >> v >> rest;
+            if (!rest.empty()) {
+                throw std::invalid_argument("[" + k + "]の行が正しくありません。");
+            }
+
+            // 値のない行は、インプットファイルと同じくデフォルト値にする
+            if (v.empty()) {
+                continue;
+            }
+
+            auto const value = [&k, &v](auto & target) {
+                try {
+                    target = boost::lexical_cast<std::remove_reference_t<decltype(target)>>(v);
+                }
+                catch (boost::bad_lexical_cast const &) {
+                    throw std::invalid_argument("[" + k + "]の値が正しくありません。");
+                }
+            };
+
+            ci_string const key(k.c_str());
+            ci_string const val(v.c_str());
+            if (key == "chemical.number") {
+                value(pdata->Z_);
+            }
+            else if (key == "grid.xmin") {
+                value(pdata->xmin_);
+            }
+            else if (key == "grid.xmax") {
+                value(pdata->xmax_);
+            }
+            else if (key == "grid.num") {
+                value(pdata->grid_num_);
+            }
+            else if (key == "eps") {
+                value(pdata->eps_);
+            }
+            else if (key == "matching.point") {
+                value(pdata->match_point_);
+            }
+            else if (key == "gauss.legendre.integ") {
+                value(pdata->gauss_legendre_integ_);
+            }
+            else if (key == "gauss.legendre.integ.norm") {
+                value(pdata->gauss_legendre_integ_norm_);
+            }
+            else if (key == "iteration.maxIter") {
+                value(pdata->iteration_maxiter_);
+            }
+            else if (key == "iteration.Mixing.Weight") {
+                value(pdata->iteration_mixing_weight_);
+            }
+            else if (key == "iteration.criterion") {
+                value(pdata->iteration_criterion_);
+            }
+            else if (key == "model" && val == "TF") {
+                pdata->model_ = Model::TF;
+            }
+            else if (key == "output.binary" && (val == "true" || val == "false")) {
+                pdata->output_binary_ = val == "true";
+            }
+            else if (key == "output.tolerance") {
+                value(pdata->output_tolerance_);
+            }
+            else {
+                throw std::invalid_argument("[" + k + "]の行は、--serveでは使えません。");
+            }
+        }
+
+        if (!(pdata->Z_ > 0.0)) {
+            throw std::invalid_argument("[chemical.number]の行が正しくありません。");
+        }
+
+        if (pdata->output_tolerance_ < 0.0) {
+            throw std::invalid_argument("[output.tolerance]の行が正しくありません。");
+        }
+
+        return pdata;
+    }
+
+    std::optional< std::vector<std::string> > Server::readrequest(FILE * in)
+    {
+        std::vector<std::string> lines;
+        std::string line;
+        for (auto c = std::fgetc(in); ; c = std::fgetc(in)) {
+            if (c != '\n' && c != EOF) {
+                line.push_back(static_cast<char>(c));
+                continue;
+            }
+
+            // コメントと前後の空白を取り除く
+            line.erase(std::min(line.find('#'), line.size()));
+            auto const first = line.find_first_not_of(" \t\r");
+            line = first == std::string::npos ? std::string() : line.substr(first, line.find_last_not_of(" \t\r") - first + 1);
+
+            if (!line.empty()) {
+                ci_string const word(line.c_str());
+                if (word == "end") {
+                    return std::make_optional(std::move(lines));
+                }
+
+                lines.push_back(line);
+                if (word == "shutdown" && lines.size() == 1) {
+                    return std::make_optional(std::move(lines));
+                }
+            }
+
+            if (c == EOF) {
+                return lines.empty() ? std::nullopt : std::make_optional(std::move(lines));
+            }
+
+            line.clear();
+        }
+    }
+
+    void Server::respond(FILE * out, Data const & data, Solver const & solver, std::uint32_t iter)
+    {
+        auto const pi = boost::math::constants::pi<double>();
+
+        auto const Z = data.Z_;
+        auto const alpha = std::cbrt(128.0 / (9.0 * pi * pi) * Z);
+        auto const [t, ene, eee] = solver.energy(Z);
+
+        // 書き込み始める前に、すべての列を作っておく（途中で失敗して応答が壊れないように）
+        auto const n = solver.size();
+        std::vector<double> x(n), y(n), r(n), rho(n);
+        solver.y(x.data(), y.data());
+        std::transform(x.begin(), x.end(), r.begin(), [alpha](auto xi) { return xi / alpha; });
+        solver.density(Z, r.data(), rho.data(), n);
+
+        if (data.output_binary_) {
+            std::fprintf(out, "OK binary %u %.15f %.15f %.15f %.15f %llu\n",
+                static_cast<unsigned int>(iter), t + ene + eee, t, ene, eee,
+                static_cast<unsigned long long>(utility::resultsize(4, n)));
+            utility::writeresult(out, { "x", "y", "r", "rho" }, { &x, &y, &r, &rho }, Z, alpha, x.front(), x[2] - x[1]);
+            return;
+        }
+
+        std::fprintf(out, "OK csv %u %.15f %.15f %.15f %.15f\n", static_cast<unsigned int>(iter), t + ene + eee, t, ene, eee);
+        {
+            utility::CsvWriter cw(out);
+            auto const write = [&cw](double xi, std::array<double, 3> const & v) { cw(xi, v[0], v[1], v[2]); };
+
+            if (data.output_tolerance_ > 0.0) {
+                utility::Decimator<3> decimator(data.output_tolerance_);
+                for (auto i = 0U; i < n; i++) {
+                    decimator(x[i], { y[i], r[i], rho[i] }, write);
+                }
+                decimator.finish(write);
+            }
+            else {
+                for (auto i = 0U; i < n; i++) {
+                    write(x[i], { y[i], r[i], rho[i] });
+                }
+            }
+
+            cw.close();
+        }
+        std::fputs("END\n", out);
+    }
+
+    bool Server::session(FILE * in, FILE * out)
+    {
+        for (auto request(readrequest(in)); request; request = readrequest(in)) {
+            if (ci_string(request->front().c_str()) == "shutdown") {
+                std::fputs("OK shutdown\n", out);
+                std::fflush(out);
+                return false;
+            }
+
+            try {
+                auto const pdata = parse(*request);
+                auto iter = 0U;
+                auto const & solver = solve(pdata, iter);
+                respond(out, *pdata, solver, iter);
+            }
+            catch (std::bad_alloc const &) {
+                std::fputs("ERROR メモリ確保に失敗しました。\n", out);
+            }
+            catch (std::exception const & e) {
+                std::fprintf(out, "ERROR %s\n", e.what());
+            }
+
+            std::fflush(out);
+        }
+
+        return true;
+    }
+
+    Solver const & Server::solve(std::shared_ptr<Data> const & pdata, std::uint32_t & iter)
+    {
+        // y(x)が同じになる設定で解いたソルバーがあれば、解き直さずに使う
+        auto const itr = std::find_if(solvers_.begin(), solvers_.end(), [&pdata](auto const & p) { return issame(*p->pdata(), *pdata); });
+        if (itr != solvers_.end()) {
+            solvers_.splice(solvers_.begin(), solvers_, itr);
+            iter = 0;
+            return *solvers_.front();
+        }
+
+        // 一杯なら一番古いソルバーを設定し直して、その解を初期関数にする
+        std::unique_ptr<Solver> psolver;
+        if (solvers_.size() < Server::CACHE_SIZE) {
+            psolver = std::make_unique<Solver>(pdata);
+        }
+        else {
+            solvers_.back()->setdata(pdata);
+            psolver = std::move(solvers_.back());
+            solvers_.pop_back();
+        }
+
+        // 収束しなかったソルバーは、設定と解が食い違うので残さない
+        iter = psolver->solve();
+        solvers_.push_front(std::move(psolver));
+
+        return *solvers_.front();
+    }
+
+    // #endregion privateメンバ関数
+}
@@ -0,0 +1,188 @@
+﻿/*! \file server.h
+    \brief ジョブを受け付けて、Thomas-Fermi方程式を解き続けるサーバーの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SERVER_H_
+#define _SERVER_H_
+
+#pragma once
+
+#include "solver.h"
+#include <cstdint>      // for std::uint32_t
+#include <cstdio>       // for FILE
+#include <list>         // for std::list
+#include <memory>       // for std::shared_ptr, std::unique_ptr
+#include <optional>     // for std::optional
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+namespace thomasfermi {
+    //! A class.
+    /*!
+        一つのプロセスで、標準入出力かUNIXドメインソケットからジョブを受け付けて
+        孤立した中性原子のThomas-Fermi方程式を解き続けるクラス
+        ジョブはインプットファイルと同じ「キー 値」の行（順不同、#以降はコメント）を並べ、
+        「end」の行で終える（「shutdown」の行はサーバーを止める）
+        応答の一行目は
+            OK csv 反復回数 E T E_ne E_ee
+            OK binary 反復回数 E T E_ne E_ee バイト数
+            ERROR メッセージ
+        のいずれかで、csvならx, y, r, rhoの行が「END」の行まで続き（output.toleranceで間引ける）、
+        binaryならresultformat.hの形式でx、y、r、rhoの列がバイト数だけ続く
+        最近解いた設定のソルバーをCACHE_SIZE個まで残しておき、y(x)は原子番号によらないので、
+        原子番号だけが違うジョブは解き直さない（反復回数は0になる）
+        一杯のときは一番古いソルバーを設定し直して、その解を初期関数にする
+    */
+    class Server final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param useomp OpenMPを使用するかどうか
+        */
+        explicit Server(bool useomp);
+
+        //! A default destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~Server() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function.
+        /*!
+            ジョブを受け付ける
+            \param path UNIXドメインソケットのパス（"-"なら標準入出力）
+        */
+        void run(std::string const & path);
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private static member function.
+        /*!
+            二つの設定で、y(x)が同じになるかどうかを調べる
+            \param lhs 一つ目の設定
+            \param rhs 二つ目の設定
+            \return y(x)が同じになるかどうか
+        */
+        static bool issame(Data const & lhs, Data const & rhs) noexcept;
+
+        //! A private member function (const).
+        /*!
+            ジョブの行を解析して、設定を作る
+            \param lines ジョブの行
+            \return 計算の設定
+        */
+        std::shared_ptr<Data> parse(std::vector<std::string> const & lines) const;
+
+        //! A private static member function.
+        /*!
+            ジョブの行を、「end」の行まで読み込む（空行とコメントは除く）
+            \param in 読み込むファイルポインタ
+            \return ジョブの行（何も読まずにファイルの終わりに達したらstd::nullopt）
+        */
+        static std::optional< std::vector<std::string> > readrequest(FILE * in);
+
+        //! A private static member function.
+        /*!
+            解いた結果を書き込む
+            \param out 書き込むファイルポインタ
+            \param data 計算の設定
+            \param solver 解いたソルバー
+            \param iter 収束するまでの反復回数
+        */
+        static void respond(FILE * out, Data const & data, Solver const & solver, std::uint32_t iter);
+
+        //! A private member function.
+        /*!
+            ファイルの終わりに達するか、shutdownの行を読むまでジョブを処理する
+            \param in 読み込むファイルポインタ
+            \param out 書き込むファイルポインタ
+            \return ジョブの受け付けを続けるかどうか
+        */
+        bool session(FILE * in, FILE * out);
+
+        //! A private member function.
+        /*!
+            設定に合ったソルバーを返す（なければ解く）
+            \param pdata 計算の設定
+            \param iter 収束するまでの反復回数（解き直さなかったときは0）
+            \return 解いたソルバー
+        */
+        Solver const & solve(std::shared_ptr<Data> const & pdata, std::uint32_t & iter);
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant expression).
+        /*!
+            残しておくソルバーの数
+        */
+        static auto constexpr CACHE_SIZE = 8U;
+
+        //! A private member variable.
+        /*!
+            最近使った順に並べたソルバー
+        */
+        std::list< std::unique_ptr<Solver> > solvers_;
+
+        //! A private member variable (constant).
+        /*!
+            OpenMPを使用するかどうか
+        */
+        bool const useomp_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Server() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        Server(Server const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        Server & operator=(Server const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SERVER_H_
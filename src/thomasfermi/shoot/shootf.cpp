@@ -17,14 +17,11 @@
 */
 
 #include "shootf.h"
-#include <cmath>                        // for std::fabs
-#include <iterator>                     // for std::advance, std::distance
-#include <utility>                      // for std::make_pair
+#include <algorithm>                    // for std::copy
+#include <array>                        // for std::array
 #include <boost/assert.hpp>             // for BOOST_ASSERT
-#include <boost/range/algorithm.hpp>    // for boost::find_if
 #include <Eigen/Dense>
 #include <Eigen/LU>                     // for Eigen::FullPivLU
-#include <gsl/gsl_spline.h>             // for gsl_interp_accel, gsl_interp_accel_free, gsl_spline, gsl_spline_free
 
 #if _OPENMP >= 200805
     #include <omp.h>
@@ -160,65 +157,52 @@ namespace thomasfermi {
                 res2 = solveodex2toxfmx1(x1, x2, xf);
             }
 
-            result = createResult(res1, res2, x1, xf);
+            createResult(res1, res2, x1, result);
         }
 
         // #endregion publicメンバ関数
 
         // #region privateメンバ関数
 
-        shootf::result_type shootf::createResult(std::vector<double> const & res1, std::vector<double> const & res2, double x1, double xf) const
+        void shootf::createResult(std::vector<double> const & res1, std::vector<double> const & res2, double x1, shootf::result_type & result) const
         {
-            auto const size = boost::numeric_cast<std::vector<double>::size_type>(res1.size() + res2.size() - 1);
+            // res1とres2の末尾は、どちらも適合点における値
+            auto const size = res1.size() + res2.size() - 1;
+            auto const xfindex = res1.size() - 1;
 
-            std::vector<double> xp, xptmp, yp;
-            xp.reserve(size);
-            xptmp.reserve(size - 1);
-            yp.reserve(size);
+            BOOST_ASSERT(xfindex >= 2 && xfindex + 2 < size);
 
-            auto const xfindex = boost::numeric_cast<std::size_t>(xf / dx_); 
+            auto & xp = result.first;
+            auto & yp = result.second;
+            xp.resize(size);
+            yp.resize(size);
 
-            for (auto i = 0U; i < xfindex; i++) {
-                xptmp.push_back(i ? static_cast<double>(i) * dx_ : x1);
+            xp[0] = x1;
+            for (auto i = 1U; i < size; i++) {
+                xp[i] = static_cast<double>(i) * dx_;
             }
 
-            for (auto i = xfindex + 1U; i < size; i++) {
-                xptmp.push_back(static_cast<double>(i) * dx_);
-            }
-
-            yp.assign(res1.begin(), res1.end() - 1);
-            auto const s = res2.size();
-            for (auto i = 1U; i < s; i++) {
-                yp.push_back(res2[s - i - 1]);
-            }
-
-            BOOST_ASSERT(xptmp.size() == yp.size());
-
-            std::unique_ptr<gsl_interp_accel, decltype(&gsl_interp_accel_free)>
-                const acc(gsl_interp_accel_alloc(), gsl_interp_accel_free);
-            std::unique_ptr<gsl_spline, decltype(&gsl_spline_free)>
-                const spline(gsl_spline_alloc(gsl_interp_cspline, yp.size()), gsl_spline_free);
-
-            gsl_spline_init(spline.get(), xptmp.data(), yp.data(), xptmp.size());
+            // 原点に近い側はそのまま、無限遠点に近い側は逆順に詰める
+            std::copy(res1.begin(), res1.end() - 1, yp.begin());
+            std::copy(res2.rbegin() + 1, res2.rend(), yp.begin() + xfindex + 1);
+
+            // 適合点の前後二点ずつを通る三次のLagrange補間で、適合点の値を求める
+            std::array<std::size_t, 4> const index = { xfindex - 2, xfindex - 1, xfindex + 1, xfindex + 2 };
+            auto const xf = xp[xfindex];
+
+            auto yf = 0.0;
+            for (auto i = 0U; i < index.size(); i++) {
+                auto l = 1.0;
+                for (auto j = 0U; j < index.size(); j++) {
+                    if (j != i) {
+                        l *= (xf - xp[index[j]]) / (xp[index[i]] - xp[index[j]]);
+                    }
+                }
 
-            for (auto i = 0U; i < size; i++) {
-                xp.push_back(i ? static_cast<double>(i) * dx_ : x1);
+                yf += l * yp[index[i]];
             }
 
-            auto iter2 = yp.begin();
-            std::advance(
-                iter2,
-                std::distance(
-                    iter2,
-                    boost::find_if(
-                        yp,
-                        [&res2, s](auto x) { return std::fabs(x - res2[s - 2]) < EPS; })));
-
-            yp.insert(iter2, gsl_spline_eval(spline.get(), xf, acc.get()));
-
-            BOOST_ASSERT(xp.size() == yp.size());
-
-            return std::make_pair(std::move(xp), std::move(yp));
+            yp[xfindex] = yf;
         }
 
         std::vector<double> shootf::solveodex2toxfmx1(double x1, double x2, double xf) const
@@ -86,13 +86,13 @@ namespace thomasfermi {
             //! A private member function (const).
             /*!
                 最終的な結果を生成する
+                適合点の値は、その前後二点ずつを通る三次のLagrange補間で求める
                 \param res1 原点に近い点から適合点までの結果
                 \param res2 無限遠点に近い点から適合点までの結果
                 \param x1 原点に近いxの値
-                \param xf 適合点に近いxの値
-                \return xのメッシュとそれに対応したyの値のtuple
+                \param result xのメッシュとそれに対応したyの値のstd::pair（戻り値として使用）
             */
-            result_type createResult(std::vector<double> const & res1, std::vector<double> const & res2, double x1, double xf) const;
+            void createResult(std::vector<double> const & res1, std::vector<double> const & res2, double x1, result_type & result) const;
 
             //! A private member function (const).
             /*!
@@ -135,12 +135,6 @@ namespace thomasfermi {
         private:
             // #region メンバ変数
 
-            //! A private member variable (constant expression).
-            /*!
-                許容誤差
-            */
-            static double constexpr EPS = 1.0E-14;
-
             //! A private member variable (constant).
             /*!
                 原点に近いxにおけるyの微分値の増分
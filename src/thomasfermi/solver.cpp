@@ -0,0 +1,177 @@
+﻿/*! \file solver.cpp
+    \brief プロセスの中で繰り返し使える、孤立した中性原子のThomas-Fermi方程式のソルバーの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "gausslegendre/gausslegendre.h"
+#include "iteration.h"
+#include "makerhoen/densitytable.h"
+#include "makerhoen/makerhoenergy.h"
+#include "solver.h"
+#include <algorithm>                            // for std::any_of, std::copy
+#include <cmath>                                // for std::cbrt
+#include <stdexcept>                            // for std::invalid_argument, std::logic_error, std::runtime_error
+#include <tuple>                                // for std::get
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace thomasfermi {
+    // #region コンストラクタ・デストラクタ
+
+    Solver::Solver(std::shared_ptr<Data> const & pdata)
+    {
+        setdata(pdata);
+    }
+
+    Solver::~Solver() = default;
+
+    // #endregion コンストラクタ・デストラクタ
+
+    // #region publicメンバ関数
+
+    Solver::energy_type Solver::energy(double Z) const
+    {
+        checksolved();
+
+        auto const pi = boost::math::constants::pi<double>();
+
+        // MakeRhoEnergyと同じく、単位はZ^2α（α = [128 / (9π ** 2)]^(1 / 3) * Z^(1 / 3)）
+        auto const c = Z * Z * std::cbrt(128.0 / (9.0 * pi * pi) * Z);
+        auto const i = integral_[1];
+        auto const j = integral_[2];
+
+        return { 0.6 * c * j, -c * i, 0.5 * c * (i - j) };
+    }
+
+    void Solver::density(double Z, double const * r, double * out, std::size_t n) const
+    {
+        checksolved();
+
+        // DensityTableは負の値やNaNの半径を検査しない（ループの分岐をなくすため）ので、ここで弾く
+        if (std::any_of(r, r + n, [](auto ri) { return !(ri >= 0.0); })) {
+            throw std::invalid_argument("原点からの距離は0以上でなければなりません。");
+        }
+
+        (*ptable_)(Z, r, out, n);
+    }
+
+    void Solver::setdata(std::shared_ptr<Data> const & pdata)
+    {
+        validate(pdata);
+
+        pdata_ = pdata;
+    }
+
+    std::uint32_t Solver::solve()
+    {
+        // 直前の解とメッシュの最小値とマッチングポイントが同じなら、その解を初期関数にする
+        // （原点に近い方の境界条件は、shooting法で求めた直前の解の値をそのまま使うため）
+        auto const warm = piter_ &&
+            piter_->PData()->xmin_ == pdata_->xmin_ && piter_->PData()->match_point_ == pdata_->match_point_;
+
+        std::unique_ptr<femall::Iteration> piter;
+        auto iter = 0U;
+        if (warm) {
+            try {
+                piter = std::make_unique<femall::Iteration>(pdata_, *piter_);
+                iter = piter->Iterationloop(false);
+            }
+            catch (std::runtime_error const &) {
+                // 直前の解から収束しなかったときは、shooting法で作った初期関数からやり直す
+                piter.reset();
+            }
+        }
+
+        if (!piter) {
+            piter = std::make_unique<femall::Iteration>(pdata_);
+            iter = piter->Iterationloop(false);
+        }
+
+        auto [x, y, yprime0] = piter->makeresult();
+
+        // エネルギーの積分と電子密度の表は原子番号によらないので、ここで一度だけ求めておく
+        gausslegendre::Gauss_Legendre const gl(static_cast<std::int32_t>(pdata_->gauss_legendre_integ_));
+        auto const integral = makerhoen::MakeRhoEnergy::integrate(x, y, gl, pdata_->useomp_);
+        auto ptable = std::make_unique<makerhoen::DensityTable>(x, y);
+
+        // ここから先は例外を投げないので、途中で失敗しても直前の解は残る
+        integral_ = integral;
+        piter_ = std::move(piter);
+        ptable_ = std::move(ptable);
+        x_ = std::move(x);
+        y_ = std::move(y);
+        yprime0_ = yprime0;
+
+        return iter;
+    }
+
+    void Solver::y(double * x, double * y) const
+    {
+        checksolved();
+
+        if (x) {
+            std::copy(x_.begin(), x_.end(), x);
+        }
+
+        if (y) {
+            std::copy(y_.begin(), y_.end(), y);
+        }
+    }
+
+    double Solver::yprime0() const
+    {
+        checksolved();
+
+        return yprime0_;
+    }
+
+    // #endregion publicメンバ関数
+
+    // #region privateメンバ関数
+
+    void Solver::checksolved() const
+    {
+        if (!ptable_) {
+            throw std::logic_error("まだ方程式を解いていません。");
+        }
+    }
+
+    void Solver::validate(std::shared_ptr<Data> const & pdata)
+    {
+        if (!pdata) {
+            throw std::invalid_argument("設定がありません。");
+        }
+
+        // Solverが解くのは、model = TFの孤立した中性原子だけ
+        if (pdata->model_ != Model::TF || !pdata->cell_density_.empty() || !pdata->ion_degree_.empty() || !pdata->temperature_.empty()) {
+            throw std::invalid_argument("Solverは、model = TFの孤立した中性原子だけを解けます。");
+        }
+
+        // 値の範囲はインプットファイルを読み込むときと同じ
+        if (pdata->xmin_ <= 0.0 || pdata->xmax_ <= pdata->xmin_ || pdata->match_point_ <= pdata->xmin_ || pdata->match_point_ >= pdata->xmax_) {
+            throw std::invalid_argument("メッシュの最小値、最大値、マッチングポイントが正しくありません。");
+        }
+
+        if (pdata->grid_num_ < 2 || !pdata->gauss_legendre_integ_ || !pdata->iteration_maxiter_) {
+            throw std::invalid_argument("メッシュの数、Gauss-Legendre積分の分点、最大ループ回数が正しくありません。");
+        }
+
+        if (pdata->iteration_mixing_weight_ <= 0.0 || pdata->iteration_mixing_weight_ > 1.0) {
+            throw std::invalid_argument("電子密度を合成するときの重みが正しくありません。");
+        }
+    }
+
+    // #endregion privateメンバ関数
+}
@@ -0,0 +1,237 @@
+﻿/*! \file solver.h
+    \brief プロセスの中で繰り返し使える、孤立した中性原子のThomas-Fermi方程式のソルバーの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _SOLVER_H_
+#define _SOLVER_H_
+
+#pragma once
+
+#include "data.h"
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t
+#include <memory>       // for std::shared_ptr, std::unique_ptr
+#include <vector>       // for std::vector
+
+namespace thomasfermi {
+    namespace femall {
+        class Iteration;
+    }
+
+    namespace makerhoen {
+        class DensityTable;
+    }
+
+    //! A class.
+    /*!
+        Data構造体で設定し、孤立した中性原子のThomas-Fermi方程式を解くクラス
+        インプットファイルもCSVファイルも使わず、結果は呼び出し側のバッファに書き込む
+        y(x)は原子番号によらないので、一度解けば任意の原子番号のエネルギーと電子密度を求められる
+        solve()は繰り返し呼べ、直前の解とメッシュの最小値とマッチングポイントが同じなら、その解を初期関数にする
+        solve()の後のconstメンバ関数は、複数のスレッドから同時に呼んでもよい
+    */
+    class Solver final {
+        // #region 型エイリアス
+
+    public:
+        using energy_type = std::array<double, 3>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param pdata 計算の設定
+        */
+        explicit Solver(std::shared_ptr<Data> const & pdata);
+
+        //! A destructor.
+        /*!
+            デストラクタ
+        */
+        ~Solver();
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (const).
+        /*!
+            原子番号Zの原子の、エネルギーの成分を求める
+            \param Z 原子番号
+            \return 運動エネルギー、電子-原子核、電子間の相互作用エネルギー（Hartree）のstd::array
+        */
+        energy_type energy(double Z) const;
+
+        //! A public member function (const).
+        /*!
+            原子番号Zの原子の、n個の半径における電子密度n(r; Z)をoutに書き込む
+            rに負の値かNaNが含まれているときは、std::invalid_argumentを投げる
+            \param Z 原子番号
+            \param r 原点からの距離（原子単位、正の値）の配列
+            \param out 電子密度を書き込む配列
+            \param n 配列の要素数
+        */
+        void density(double Z, double const * r, double * out, std::size_t n) const;
+
+        //! A public member function (const).
+        /*!
+            解いた設定を返す
+            \return 計算の設定
+        */
+        std::shared_ptr<Data> const & pdata() const noexcept
+        {
+            return pdata_;
+        }
+
+        //! A public member function.
+        /*!
+            設定を変える（直前の解は、次のsolve()の初期関数に使うために残す）
+            \param pdata 新しい計算の設定
+        */
+        void setdata(std::shared_ptr<Data> const & pdata);
+
+        //! A public member function (const).
+        /*!
+            メッシュの節点の数を返す
+            \return メッシュの節点の数（解いていなければ0）
+        */
+        std::size_t size() const noexcept
+        {
+            return x_.size();
+        }
+
+        //! A public member function.
+        /*!
+            Thomas-Fermi方程式を解く
+            \return 収束するまでの反復回数
+        */
+        std::uint32_t solve();
+
+        //! A public member function (const).
+        /*!
+            x方向のメッシュと収束したy(x)を、それぞれsize()個の要素を持つ配列に書き込む
+            \param x x方向のメッシュを書き込む配列（nullptrなら書き込まない）
+            \param y y(x)を書き込む配列（nullptrなら書き込まない）
+        */
+        void y(double * x, double * y) const;
+
+        //! A public member function (const).
+        /*!
+            原点におけるyの微分値を返す
+            \return y'(0)
+        */
+        double yprime0() const;
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private member function (const).
+        /*!
+            解いていなければ例外を投げる
+        */
+        void checksolved() const;
+
+        //! A private static member function.
+        /*!
+            設定が正しいかどうかを調べ、正しくなければ例外を投げる
+            \param pdata 計算の設定
+        */
+        static void validate(std::shared_ptr<Data> const & pdata);
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            規格化の積分∫√x y^(3/2)dx、I = ∫y^(3/2) / √x dx、J = ∫y^(5/2) / √x dx
+        */
+        std::array<double, 3> integral_;
+
+        //! A private member variable.
+        /*!
+            計算の設定
+        */
+        std::shared_ptr<Data> pdata_;
+
+        //! A private member variable.
+        /*!
+            直前に収束したIterationオブジェクト（次のsolve()の初期関数に使う）
+        */
+        std::unique_ptr<femall::Iteration> piter_;
+
+        //! A private member variable.
+        /*!
+            電子密度の表
+        */
+        std::unique_ptr<makerhoen::DensityTable> ptable_;
+
+        //! A private member variable.
+        /*!
+            x方向のメッシュ
+        */
+        std::vector<double> x_;
+
+        //! A private member variable.
+        /*!
+            収束したy(x)
+        */
+        std::vector<double> y_;
+
+        //! A private member variable.
+        /*!
+            原点におけるyの微分値
+        */
+        double yprime0_ = 0.0;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Solver() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        Solver(Solver const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        Solver & operator=(Solver const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _SOLVER_H_
@@ -0,0 +1,317 @@
+﻿/*! \file source.h
+    \brief 有限の半径を持つ原子・イオンの微分方程式の非線形項（ソース項）のポリシークラスの宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef _SOURCE_H_
+#define _SOURCE_H_
+
+#pragma once
+
+#include "fermidirac.h"
+#include <algorithm>                            // for std::max
+#include <cmath>                                // for std::cbrt, std::pow, std::sqrt
+#include <vector>                               // for std::vector
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+
+namespace thomasfermi {
+    namespace femall {
+        //! A struct.
+        /*!
+            Thomas-Fermi方程式のソース項のポリシー
+            t = x / x0のとき、d^2y/dt^2 = x0^(3/2) * y^(3/2) / √t
+        */
+        struct TFSource final {
+            // #region コンストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param Z 原子番号（ソース項は原子番号によらないので未使用）
+            */
+            explicit TFSource([[maybe_unused]] double Z) noexcept
+            {
+            }
+
+            // #endregion コンストラクタ
+
+            // #region メンバ関数
+
+            //! A public member function (const).
+            /*!
+                ソース項の値を返す
+                \param x0 原子・イオンの半径
+                \param t t = x / x0
+                \param y y(t)の値
+                \return ソース項の値
+            */
+            double operator()(double x0, double t, double y) const noexcept
+            {
+                y = std::max(y, 0.0);
+                return x0 * std::sqrt(x0) * y * std::sqrt(y / t);
+            }
+
+            //! A public member function (const).
+            /*!
+                メッシュの全ての節点について、ソース項の値を求める
+                \param x0 原子・イオンの半径
+                \param t tのメッシュ
+                \param y yの値
+                \param beta ソース項の値を格納する配列
+            */
+            void operator()(double x0, std::vector<double> const & t, std::vector<double> const & y, std::vector<double> & beta) const
+            {
+                beta.resize(t.size());
+                for (auto i = 0U; i < t.size(); i++) {
+                    beta[i] = (*this)(x0, t[i], y[i]);
+                }
+            }
+
+            //! A public member function (const).
+            /*!
+                境界（t = 1）におけるyの値を返す
+                \param x0 原子・イオンの半径
+                \return y(1)の値
+            */
+            double edge([[maybe_unused]] double x0) const noexcept
+            {
+                return 0.0;
+            }
+
+            // #endregion メンバ関数
+
+            // #region メンバ変数
+
+            //! A public member variable (constant expression).
+            /*!
+                解が原子番号に依存するかどうか
+            */
+            static auto constexpr ZDEPENDENT = false;
+
+            //! A public member variable (constant expression).
+            /*!
+                ソース項が温度に依存するかどうか
+            */
+            static auto constexpr TDEPENDENT = false;
+
+            // #endregion メンバ変数
+        };
+
+        //! A struct.
+        /*!
+            Thomas-Fermi-Dirac方程式のソース項のポリシー
+            t = x / x0のとき、d^2y/dt^2 = x0^3 * t * [√(y / x) + β0]^3
+            （β0 = [3 / (32π^2)]^(1 / 3) * Z^(-2 / 3)）
+        */
+        struct TFDSource final {
+            // #region コンストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param Z 原子番号
+            */
+            explicit TFDSource(double Z) noexcept
+                :   beta0_(std::cbrt(3.0 / (32.0 * boost::math::constants::pi_sqr<double>())) * std::pow(Z, -2.0 / 3.0))
+            {
+            }
+
+            // #endregion コンストラクタ
+
+            // #region メンバ関数
+
+            //! A public member function (const).
+            /*!
+                ソース項の値を返す
+                \param x0 原子・イオンの半径
+                \param t t = x / x0
+                \param y y(t)の値
+                \return ソース項の値
+            */
+            double operator()(double x0, double t, double y) const noexcept
+            {
+                auto const x = x0 * t;
+                auto const s = std::sqrt(std::max(y, 0.0) / x) + beta0_;
+                return x0 * x0 * x * s * s * s;
+            }
+
+            //! A public member function (const).
+            /*!
+                メッシュの全ての節点について、ソース項の値を求める
+                \param x0 原子・イオンの半径
+                \param t tのメッシュ
+                \param y yの値
+                \param beta ソース項の値を格納する配列
+            */
+            void operator()(double x0, std::vector<double> const & t, std::vector<double> const & y, std::vector<double> & beta) const
+            {
+                beta.resize(t.size());
+                for (auto i = 0U; i < t.size(); i++) {
+                    beta[i] = (*this)(x0, t[i], y[i]);
+                }
+            }
+
+            //! A public member function (const).
+            /*!
+                境界（t = 1）におけるyの値を返す
+                境界で圧力が0になる条件√(y / x0) = β0 / 4から決まる
+                \param x0 原子・イオンの半径
+                \return y(1)の値
+            */
+            double edge(double x0) const noexcept
+            {
+                return x0 * beta0_ * beta0_ / 16.0;
+            }
+
+            // #endregion メンバ関数
+
+            // #region メンバ変数
+
+            //! A public member variable (constant expression).
+            /*!
+                解が原子番号に依存するかどうか
+            */
+            static auto constexpr ZDEPENDENT = true;
+
+            //! A public member variable (constant expression).
+            /*!
+                ソース項が温度に依存するかどうか
+            */
+            static auto constexpr TDEPENDENT = false;
+
+            //! A public member variable (constant).
+            /*!
+                交換項の係数β0
+            */
+            double const beta0_;
+
+            // #endregion メンバ変数
+        };
+
+        //! A struct.
+        /*!
+            有限温度のThomas-Fermi方程式のソース項のポリシー
+            t = x / x0のとき、d^2y/dt^2 = (3/2)x0^3 * t * τ^(3/2) * F_{1/2}(y / (xτ))
+            （τ = bT / Z、bはThomas-Fermiの長さの単位、F_{1/2}は完全Fermi-Dirac積分）
+            T → 0の極限でTFSourceに一致する
+        */
+        struct FTSource final {
+            // #region コンストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param Z 原子番号
+                \param T 温度（Hartree）
+            */
+            FTSource(double Z, double T)
+                :   fd_(fermidirac::FermiDirac::Instance()),
+                    tau_(std::cbrt(9.0 * boost::math::constants::pi_sqr<double>() / (128.0 * Z)) * T / Z)
+            {
+            }
+
+            // #endregion コンストラクタ
+
+            // #region メンバ関数
+
+            //! A public member function (const).
+            /*!
+                ソース項の値を返す
+                \param x0 原子・イオンの半径
+                \param t t = x / x0
+                \param y y(t)の値
+                \return ソース項の値
+            */
+            double operator()(double x0, double t, double y) const noexcept
+            {
+                auto const x = x0 * t;
+                return 1.5 * x0 * x0 * x * tau_ * std::sqrt(tau_) * fd_(y / (x * tau_));
+            }
+
+            //! A public member function (const).
+            /*!
+                メッシュの全ての節点について、ソース項の値を求める
+                F_{1/2}はまとめて評価する
+                \param x0 原子・イオンの半径
+                \param t tのメッシュ
+                \param y yの値
+                \param beta ソース項の値を格納する配列
+            */
+            void operator()(double x0, std::vector<double> const & t, std::vector<double> const & y, std::vector<double> & beta) const
+            {
+                auto const size = t.size();
+
+                std::vector<double> eta(size);
+                for (auto i = 0U; i < size; i++) {
+                    eta[i] = y[i] / (x0 * t[i] * tau_);
+                }
+
+                beta.resize(size);
+                fd_(eta.data(), beta.data(), size);
+
+                auto const c = 1.5 * x0 * x0 * x0 * tau_ * std::sqrt(tau_);
+                for (auto i = 0U; i < size; i++) {
+                    beta[i] *= c * t[i];
+                }
+            }
+
+            //! A public member function (const).
+            /*!
+                境界（t = 1）におけるyの値を返す
+                有限温度の原子はセルの中でだけ解くので、境界値は反復で決まる（ここでは初期値を返す）
+                \param x0 原子・イオンの半径
+                \return y(1)の初期値
+            */
+            double edge([[maybe_unused]] double x0) const noexcept
+            {
+                return 0.0;
+            }
+
+            // #endregion メンバ関数
+
+            // #region メンバ変数
+
+            //! A public member variable (constant expression).
+            /*!
+                解が原子番号に依存するかどうか
+            */
+            static auto constexpr ZDEPENDENT = true;
+
+            //! A public member variable (constant expression).
+            /*!
+                ソース項が温度に依存するかどうか
+            */
+            static auto constexpr TDEPENDENT = true;
+
+            //! A public member variable (constant).
+            /*!
+                Fermi-Dirac積分の評価オブジェクト
+            */
+            fermidirac::FermiDirac const & fd_;
+
+            //! A public member variable (constant).
+            /*!
+                Thomas-Fermi単位での温度τ = bT / Z
+            */
+            double const tau_;
+
+            // #endregion メンバ変数
+        };
+    }
+}
+
+#endif  // _SOURCE_H_
@@ -0,0 +1,736 @@
+﻿/*! \file tfwiteration.cpp
+    \brief Thomas-Fermi-λWeizsäcker模型の方程式をNewton法で解くクラスの実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "fem.h"
+#include "linearequations.h"
+#include "tfwiteration.h"
+#include "gausslegendre/gausslegendre.h"
+#include "utility/chainsweep.h"
+#include "utility/csvwriter.h"
+#include <algorithm>                            // for std::max_element, std::sort
+#include <cmath>                                // for std::abs, std::exp, std::log, std::pow, std::sqrt
+#include <cstdio>                               // for std::fopen, std::fprintf
+#include <iostream>                             // for std::cout
+#include <stdexcept>                            // for std::invalid_argument, std::logic_error, std::runtime_error
+#include <utility>                              // for std::make_pair, std::pair
+#include <boost/assert.hpp>                     // for BOOST_ASSERT
+#include <boost/format.hpp>                     // for boost::format
+#include <boost/math/constants/constants.hpp>   // for boost::math::constants::pi
+#include <mkl_lapack.h>                         // for dgbtrf_, dgbtrs_
+#include <omp.h>                                // for omp_get_max_threads
+
+namespace thomasfermi {
+    namespace femall {
+        // #region コンストラクタ
+
+        TFWIteration::TFWIteration(std::shared_ptr<Data> const & pdata, double Z) :
+            eneutral_(0.0),
+            lambda_(pdata->weizsacker_lambda_),
+            mu_(0.0),
+            N_(0.0),
+            pdata_(pdata),
+            Z_(Z)
+        {
+            gausslegendre::Gauss_Legendre const gl(pdata_->gauss_legendre_integ_);
+            glw_ = gl.W();
+            glx_ = gl.X();
+
+            // rの対数メッシュを生成する（xmin、xmaxはThomas-Fermiの単位x = r / aで与える）
+            // 1 / a = [128 / (9π ** 2)]^(1 / 3) * Z^(1 / 3)
+            auto const alpha = std::pow(128.0 / (9.0 * std::pow(boost::math::constants::pi<double>(), 2)) * Z_, 1.0 / 3.0);
+            auto const rmin = pdata_->xmin_ / alpha;
+            auto const rmax = pdata_->xmax_ / alpha;
+            auto const n = pdata_->grid_num_;
+            auto const dlog = std::log(rmax / rmin) / static_cast<double>(n - 1);
+
+            r_.resize(n + 1);
+            r_[0] = 0.0;
+            for (auto i = 1U; i < n; i++) {
+                r_[i] = rmin * std::exp(static_cast<double>(i - 1) * dlog);
+            }
+            r_[n] = rmax;
+
+            // 剛性行列と重なり行列はメッシュだけで決まるので、ここで一度だけ生成する
+            k0_.assign(n + 1, 0.0);
+            k1_.assign(n + 1, 0.0);
+            m0_.assign(n + 1, 0.0);
+            m1_.assign(n + 1, 0.0);
+            for (auto i = 0U; i < n; i++) {
+                auto const h = r_[i + 1] - r_[i];
+
+                k0_[i] += 1.0 / h;
+                k0_[i + 1] += 1.0 / h;
+                k1_[i] = -1.0 / h;
+
+                m0_[i] += h / 3.0;
+                m0_[i + 1] += h / 3.0;
+                m1_[i] = h / 6.0;
+            }
+
+            u_.assign(n + 1, 0.0);
+            w_.assign(n + 1, 0.0);
+        }
+
+        // #endregion コンストラクタ
+
+        // #region publicメンバ関数
+
+        void TFWIteration::Iterationloop(double q)
+        {
+            BOOST_ASSERT(q >= 0.0 && q < 1.0);
+
+            auto const N = Z_ * (1.0 - q);
+
+            if (N_ == 0.0) {
+                // 初めて解くときは、Sommerfeldの近似解から作ったThomas-Fermi模型の電子密度を初期値として、まず中性原子を解く
+                // （イオンを直接解くと、Newton法が中性原子の近くでしか収束しないため）
+                // ρ = [2Zχ(x) / s]^(3 / 2) / (3π^2)、χ(x) = [1 + (x^3 / 144)^(λ / 3)]^(-3 / λ)
+                // Thomas-Fermi模型の電子密度は原点で発散し、Weizsäckerの運動エネルギーが有限にならないので、
+                // 原点付近の長さλ_W / Zの範囲ではs = √(r^2 + (λ_W / Z)^2)として有限の値にする
+                auto const pi = boost::math::constants::pi<double>();
+                auto const alpha = std::pow(128.0 / (9.0 * pi * pi) * Z_, 1.0 / 3.0);
+                auto const rc = lambda_ / Z_;
+                auto const lambda = 0.772;
+                auto const size = r_.size();
+                for (auto i = 1U; i < size - 1; i++) {
+                    auto const s = std::sqrt(r_[i] * r_[i] + rc * rc);
+                    auto const x = alpha * s;
+                    auto const chi = std::pow(1.0 + std::pow(x * x * x / 144.0, lambda / 3.0), -3.0 / lambda);
+                    auto const phi = 2.0 * Z_ * chi / s;
+                    u_[i] = std::sqrt(4.0 * r_[i] * r_[i] * phi * std::sqrt(phi) / (3.0 * pi));
+                }
+
+                N_ = Z_;
+                w_ = hartree();
+
+                newton();
+                validate();
+                eneutral_ = total();
+            }
+
+            // 電子数を目標の値まで変えながら、直前の解を初期値として解いていく
+            // 収束しないか、基底状態でない解に収束したら、直前の解に戻して刻み幅を半分にする
+            auto step = N - N_;
+            auto nhalve = 0U;
+            while (N_ != N) {
+                auto const u(u_);
+                auto const w(w_);
+                auto const mu = mu_;
+                auto const Nprev = N_;
+
+                try {
+                    auto const Nnext = std::abs(step) < std::abs(N - N_) ? N_ + step : N;
+
+                    // 直前の解を電子数で規格化し直して初期値とする
+                    for (auto & wi : w_) {
+                        wi *= Nnext / N_;
+                    }
+
+                    N_ = Nnext;
+
+                    newton();
+                    validate();
+                }
+                catch (std::runtime_error const &) {
+                    if (++nhalve > TFWIteration::RAMP_MAXHALVING) {
+                        throw;
+                    }
+
+                    u_ = u;
+                    w_ = w;
+                    mu_ = mu;
+                    N_ = Nprev;
+                    step *= 0.5;
+                    continue;
+                }
+
+                // 収束したら、刻み幅を元に戻していく
+                nhalve = 0U;
+                step *= 2.0;
+            }
+        }
+
+        TFWIteration::result_type TFWIteration::makeresult() const
+        {
+            std::vector<double> rho(u_.size());
+            for (auto i = 0U; i < u_.size(); i++) {
+                rho[i] = u_[i] * u_[i];
+            }
+
+            return std::make_tuple(r_, std::move(rho), mu_, energy());
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+        double TFWIteration::dot(std::vector<double> const & a0, std::vector<double> const & a1, std::vector<double> const & x) const
+        {
+            auto const ax(matvec(a0, a1, x));
+
+            auto sum = 0.0;
+            for (auto i = 0U; i < x.size(); i++) {
+                sum += x[i] * ax[i];
+            }
+
+            return sum;
+        }
+
+        template <typename Function>
+        void TFWIteration::elementloop(Function && func) const
+        {
+            auto const nelem = r_.size() - 1;
+
+            if (pdata_->useomp_) {
+                auto const n = static_cast<std::int32_t>(nelem);
+#pragma omp parallel for
+                for (auto ielem = 0; ielem < n; ielem++) {
+                    func(static_cast<std::size_t>(ielem), r_[ielem], r_[ielem + 1] - r_[ielem]);
+                }
+            }
+            else {
+                for (auto ielem = 0U; ielem < nelem; ielem++) {
+                    func(static_cast<std::size_t>(ielem), r_[ielem], r_[ielem + 1] - r_[ielem]);
+                }
+            }
+        }
+
+        TFWIteration::energy_type TFWIteration::energy() const
+        {
+            auto const pi = boost::math::constants::pi<double>();
+
+            // C_F = (3 / 10)(3π^2)^(2 / 3)
+            auto const cf = 0.3 * std::pow(3.0 * pi * pi, 2.0 / 3.0);
+
+            std::vector<energy_type> e(r_.size() - 1);
+
+            elementloop([this, cf, pi, &e](std::size_t ielem, double a, double h) {
+                auto const u0 = u_[ielem];
+                auto const u1 = u_[ielem + 1];
+                auto const w0 = w_[ielem];
+                auto const w1 = w_[ielem + 1];
+
+                // u'は要素内で一定
+                auto const du = (u1 - u0) / h;
+                energy_type sum = { 0.0, 0.5 * du * du * h, 0.0, 0.0 };
+
+                for (auto k = 0U; k < glx_.size(); k++) {
+                    auto const n1 = 0.5 * (1.0 + glx_[k]);
+                    auto const r = a + h * n1;
+                    auto const wt = 0.5 * h * glw_[k];
+
+                    auto const u = u0 + (u1 - u0) * n1;
+                    auto const w = w0 + (w1 - w0) * n1;
+                    auto const rho = u * u / (4.0 * pi * r * r);
+
+                    sum[0] += wt * cf * 4.0 * pi * r * r * std::pow(rho, 5.0 / 3.0);
+                    sum[2] -= wt * Z_ * u * u / r;
+                    sum[3] += wt * 0.5 * w / r * u * u;
+                }
+
+                e[ielem] = sum;
+            });
+
+            energy_type sum = { 0.0, 0.0, 0.0, 0.0 };
+            for (auto const & ei : e) {
+                for (auto j = 0U; j < sum.size(); j++) {
+                    sum[j] += ei[j];
+                }
+            }
+
+            return sum;
+        }
+
+        void TFWIteration::factorize()
+        {
+            auto const pi = boost::math::constants::pi<double>();
+
+            // (1 / 2)(3π^2ρ)^(2 / 3) = c|u|^(4 / 3) / r^(4 / 3)
+            auto const c = 0.5 * std::pow(0.75 * pi, 2.0 / 3.0);
+
+            // 要素ごとの∫V'N_iN_jdr（V' = (7 / 3)V_TF + (w - Z) / r）と∫(u / r)N_iN_jdrを求める
+            auto const nelem = r_.size() - 1;
+            std::vector< std::array<double, 6> > elem(nelem);
+
+            elementloop([this, c, &elem](std::size_t ielem, double a, double h) {
+                auto const u0 = u_[ielem];
+                auto const u1 = u_[ielem + 1];
+                auto const w0 = w_[ielem];
+                auto const w1 = w_[ielem + 1];
+
+                std::array<double, 6> sum = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+                for (auto k = 0U; k < glx_.size(); k++) {
+                    auto const n1 = 0.5 * (1.0 + glx_[k]);
+                    auto const n0 = 1.0 - n1;
+                    auto const r = a + h * n1;
+                    auto const wt = 0.5 * h * glw_[k];
+
+                    auto const u = u0 + (u1 - u0) * n1;
+                    auto const w = w0 + (w1 - w0) * n1;
+
+                    auto const vp = wt * (7.0 / 3.0 * c * std::pow(std::abs(u) / r, 4.0 / 3.0) + (w - Z_) / r);
+                    auto const cu = wt * u / r;
+
+                    sum[0] += vp * n0 * n0;
+                    sum[1] += vp * n1 * n1;
+                    sum[2] += vp * n0 * n1;
+                    sum[3] += cu * n0 * n0;
+                    sum[4] += cu * n1 * n1;
+                    sum[5] += cu * n0 * n1;
+                }
+
+                elem[ielem] = sum;
+            });
+
+            // 節点iのuを2i番目、wを2i + 1番目の未知数とする
+            auto const n = 2 * (nelem + 1);
+            ab_.assign(TFWIteration::LDAB * n, 0.0);
+
+            auto const add = [this, nelem](std::size_t row, std::size_t col, double v) {
+                // 境界の節点の行と列は単位行列にする
+                auto const isbc = [nelem](std::size_t i) { return i / 2 == 0 || i / 2 == nelem; };
+                if (!isbc(row) && !isbc(col)) {
+                    ab_[col * TFWIteration::LDAB + TFWIteration::KL + TFWIteration::KU + row - col] += v;
+                }
+            };
+
+            for (auto i = 0U; i < nelem; i++) {
+                auto const [pl, pr, po, cl, cr, co] = elem[i];
+                auto const h = r_[i + 1] - r_[i];
+                auto const k = 1.0 / h;
+                auto const ui = 2 * i, wi = 2 * i + 1, uj = 2 * i + 2, wj = 2 * i + 3;
+
+                // ∂R_u / ∂u = (λ / 2)K + P' - μM
+                add(ui, ui, 0.5 * lambda_ * k + pl - mu_ * h / 3.0);
+                add(uj, uj, 0.5 * lambda_ * k + pr - mu_ * h / 3.0);
+                add(ui, uj, -0.5 * lambda_ * k + po - mu_ * h / 6.0);
+                add(uj, ui, -0.5 * lambda_ * k + po - mu_ * h / 6.0);
+
+                // ∂R_u / ∂w = ∂R_w / ∂u = C
+                add(ui, wi, cl);
+                add(wi, ui, cl);
+                add(uj, wj, cr);
+                add(wj, uj, cr);
+                add(ui, wj, co);
+                add(wj, ui, co);
+                add(uj, wi, co);
+                add(wi, uj, co);
+
+                // ∂R_w / ∂w = -(1 / 2)K
+                add(wi, wi, -0.5 * k);
+                add(wj, wj, -0.5 * k);
+                add(wi, wj, 0.5 * k);
+                add(wj, wi, 0.5 * k);
+            }
+
+            for (auto const i : { std::size_t(0), std::size_t(1), n - 2, n - 1 }) {
+                ab_[i * TFWIteration::LDAB + TFWIteration::KL + TFWIteration::KU] = 1.0;
+            }
+
+            auto nn = static_cast<std::int32_t>(n);
+            auto kl = TFWIteration::KL;
+            auto ku = TFWIteration::KU;
+            auto ldab = TFWIteration::LDAB;
+
+            ipiv_.resize(n);
+
+            std::int32_t info;
+            dgbtrf_(&nn, &nn, &kl, &ku, ab_.data(), &ldab, ipiv_.data(), &info);
+
+            if (info > 0) {
+                throw std::logic_error("U is singular");
+            }
+            else if (info < 0) {
+                auto const str = (boost::format("%d-th argument has illegal value") % std::abs(info)).str();
+
+                throw std::invalid_argument(str);
+            }
+        }
+
+        std::vector<double> TFWIteration::hartree() const
+        {
+            // -w'' = u^2 / rの弱形式の右辺∫(u^2 / r)N_i drを作る
+            auto const nelem = r_.size() - 1;
+            std::vector<double> bl(nelem), br(nelem);
+
+            elementloop([this, &bl, &br](std::size_t ielem, double a, double h) {
+                auto const u0 = u_[ielem];
+                auto const u1 = u_[ielem + 1];
+
+                auto sl = 0.0, sr = 0.0;
+                for (auto k = 0U; k < glx_.size(); k++) {
+                    auto const n1 = 0.5 * (1.0 + glx_[k]);
+                    auto const r = a + h * n1;
+                    auto const u = u0 + (u1 - u0) * n1;
+                    auto const f = 0.5 * h * glw_[k] * u * u / r;
+
+                    sl += f * (1.0 - n1);
+                    sr += f * n1;
+                }
+
+                bl[ielem] = sl;
+                br[ielem] = sr;
+            });
+
+            std::vector<double> b(nelem + 1, 0.0);
+            for (auto i = 0U; i < nelem; i++) {
+                b[i] += bl[i];
+                b[i + 1] += br[i];
+            }
+
+            // w(0) = 0、w(R) = N
+            std::vector<std::size_t> const i_bc_given = { 0, nelem };
+            Linear_equations le(std::make_tuple(k0_, k1_, std::vector<double>(), std::move(b)));
+            le.bound<Element::First>(2, i_bc_given, 2, i_bc_given, { 0.0, N_ });
+
+            return le.LEsolver<Element::First>();
+        }
+
+        std::vector<double> TFWIteration::matvec(std::vector<double> const & a0, std::vector<double> const & a1, std::vector<double> const & x) const
+        {
+            auto const size = x.size();
+            std::vector<double> ax(size);
+
+            for (auto i = 0U; i < size; i++) {
+                ax[i] = a0[i] * x[i];
+                if (i > 0) {
+                    ax[i] += a1[i - 1] * x[i - 1];
+                }
+                if (i < size - 1) {
+                    ax[i] += a1[i] * x[i + 1];
+                }
+            }
+
+            return ax;
+        }
+
+        void TFWIteration::newton()
+        {
+            auto const size = r_.size();
+
+            std::vector<double> res;
+            auto norm = residual(u_, w_, mu_, res);
+            auto refactor = true;
+
+            for (auto i = 1U; i < pdata_->iteration_maxiter_; i++) {
+                if (refactor) {
+                    factorize();
+                }
+
+                // J(δu, δw) - (Mu)δμ = -R、-(Mu)^T δu = 0を、Jについての二つの連立方程式に分けて解く
+                std::vector<double> g(2 * size, 0.0);
+                auto const mu_u(matvec(m0_, m1_, u_));
+                for (auto j = 1U; j < size - 1; j++) {
+                    g[2 * j] = -mu_u[j];
+                }
+
+                for (auto & r : res) {
+                    r = -r;
+                }
+
+                auto const y(solve(res));
+                auto const z(solve(g));
+
+                auto gy = 0.0, gz = 0.0;
+                for (auto j = 0U; j < 2 * size; j++) {
+                    gy += g[j] * y[j];
+                    gz += g[j] * z[j];
+                }
+                auto const dmu = gy / gz;
+
+                // Newton法の修正量と、それによる電子密度の変化のL2ノルム
+                std::vector<double> du(size), dw(size), drho(size);
+                for (auto k = 0U; k < size; k++) {
+                    du[k] = y[2 * k] - dmu * z[2 * k];
+                    dw[k] = y[2 * k + 1] - dmu * z[2 * k + 1];
+                    drho[k] = 2.0 * u_[k] * du[k];
+                }
+                auto const normrd = std::sqrt(dot(m0_, m1_, drho));
+
+                // 残差が減るまで、ステップ幅を半分にしていく
+                // uは常に規格化し、μはRayleigh商とする
+                auto alpha = 1.0;
+                std::vector<double> u(size), w(size);
+                auto trialnorm = norm;
+                auto trialmu = mu_;
+                for (auto j = 0U; j < TFWIteration::LINESEARCH_MAXITER; j++, alpha *= 0.5) {
+                    for (auto k = 0U; k < size; k++) {
+                        u[k] = u_[k] + alpha * du[k];
+                        w[k] = w_[k] + alpha * dw[k];
+                    }
+
+                    trialnorm = residual(u, w, trialmu, res);
+                    if (trialnorm < norm) {
+                        break;
+                    }
+                }
+
+                auto const accepted = trialnorm < norm;
+                if (accepted) {
+                    // 収束が遅いときは、次の反復でJacobi行列を分解し直す
+                    auto const reuse = trialnorm < TFWIteration::REUSE_RATIO * norm;
+
+                    u_.swap(u);
+                    w_.swap(w);
+                    mu_ = trialmu;
+                    norm = trialnorm;
+
+                    if (normrd < pdata_->iteration_criterion_ * N_) {
+                        return;
+                    }
+
+                    // 分解し直したJacobi行列でも修正量をそのまま使えないのは、解の近くでは
+                    // 残差が丸め誤差の大きさまで下がったときなので、収束とする
+                    if (refactor && alpha < 1.0 && normrd < std::sqrt(pdata_->iteration_criterion_) * N_) {
+                        return;
+                    }
+
+                    refactor = !reuse;
+                    continue;
+                }
+
+                if (refactor) {
+                    if (normrd < std::sqrt(pdata_->iteration_criterion_) * N_) {
+                        return;
+                    }
+
+                    throw std::runtime_error("収束しませんでした。");
+                }
+
+                // 使い回した分解では残差が減らなかったので、分解し直してやり直す
+                refactor = true;
+                residual(u_, w_, mu_, res);
+            }
+
+            throw std::runtime_error("収束しませんでした。");
+        }
+
+        double TFWIteration::residual(std::vector<double> & u, std::vector<double> const & w, double & mu, std::vector<double> & res) const
+        {
+            // uを規格化する（∫u^2dr = N）
+            auto const unorm = std::sqrt(N_ / dot(m0_, m1_, u));
+            for (auto & ui : u) {
+                ui *= unorm;
+            }
+
+            auto const pi = boost::math::constants::pi<double>();
+
+            // (1 / 2)(3π^2ρ)^(2 / 3) = c|u|^(4 / 3) / r^(4 / 3)
+            auto const c = 0.5 * std::pow(0.75 * pi, 2.0 / 3.0);
+
+            // 要素ごとの∫VuN_idrと∫(u^2 / r)N_idrを求める
+            auto const nelem = r_.size() - 1;
+            std::vector< std::array<double, 4> > elem(nelem);
+
+            elementloop([this, c, &u, &w, &elem](std::size_t ielem, double a, double h) {
+                auto const u0 = u[ielem];
+                auto const u1 = u[ielem + 1];
+                auto const w0 = w[ielem];
+                auto const w1 = w[ielem + 1];
+
+                std::array<double, 4> sum = { 0.0, 0.0, 0.0, 0.0 };
+                for (auto k = 0U; k < glx_.size(); k++) {
+                    auto const n1 = 0.5 * (1.0 + glx_[k]);
+                    auto const n0 = 1.0 - n1;
+                    auto const r = a + h * n1;
+                    auto const wt = 0.5 * h * glw_[k];
+
+                    auto const uh = u0 + (u1 - u0) * n1;
+                    auto const wh = w0 + (w1 - w0) * n1;
+
+                    auto const vu = wt * (c * std::pow(std::abs(uh) / r, 4.0 / 3.0) + (wh - Z_) / r) * uh;
+                    auto const b = wt * uh * uh / r;
+
+                    sum[0] += vu * n0;
+                    sum[1] += vu * n1;
+                    sum[2] += b * n0;
+                    sum[3] += b * n1;
+                }
+
+                elem[ielem] = sum;
+            });
+
+            auto const size = nelem + 1;
+            std::vector<double> vu(size, 0.0), b(size, 0.0);
+            for (auto i = 0U; i < nelem; i++) {
+                vu[i] += elem[i][0];
+                vu[i + 1] += elem[i][1];
+                b[i] += elem[i][2];
+                b[i + 1] += elem[i][3];
+            }
+
+            auto const ku(matvec(k0_, k1_, u));
+            auto const kw(matvec(k0_, k1_, w));
+            auto const mu_u(matvec(m0_, m1_, u));
+
+            // μはRayleigh商u^T((λ / 2)Ku + ∫VuN_idr) / Nとする
+            auto rq = 0.0;
+            for (auto i = 1U; i < size - 1; i++) {
+                rq += u[i] * (0.5 * lambda_ * ku[i] + vu[i]);
+            }
+            mu = rq / N_;
+
+            // R_u = (λ / 2)Ku + ∫VuN_idr - μMu、R_w = -(1 / 2)(Kw - b)（境界の節点の残差は0）
+            res.assign(2 * size, 0.0);
+            auto sum = 0.0;
+            for (auto i = 1U; i < size - 1; i++) {
+                res[2 * i] = 0.5 * lambda_ * ku[i] + vu[i] - mu * mu_u[i];
+                res[2 * i + 1] = -0.5 * (kw[i] - b[i]);
+
+                sum += res[2 * i] * res[2 * i] + res[2 * i + 1] * res[2 * i + 1];
+            }
+
+            return std::sqrt(sum);
+        }
+
+        std::vector<double> TFWIteration::solve(std::vector<double> b) const
+        {
+            auto trans = 'N';
+            auto n = static_cast<std::int32_t>(b.size());
+            auto kl = TFWIteration::KL;
+            auto ku = TFWIteration::KU;
+            auto nrhs = 1;
+            auto ldab = TFWIteration::LDAB;
+
+            std::int32_t info;
+            dgbtrs_(&trans, &n, &kl, &ku, &nrhs, ab_.data(), &ldab, ipiv_.data(), b.data(), &n, &info);
+
+            if (info < 0) {
+                auto const str = (boost::format("%d-th argument has illegal value") % std::abs(info)).str();
+
+                throw std::invalid_argument(str);
+            }
+
+            return b;
+        }
+
+        double TFWIteration::total() const
+        {
+            auto const [ttf, tw, ene, eh] = energy();
+
+            return ttf + lambda_ * tw + ene + eh;
+        }
+
+        void TFWIteration::validate() const
+        {
+            // 基底状態のuは内側の節点で符号を変えない（uと-uはどちらも解なので、絶対値が最大の点の符号に揃えて見る）
+            auto const itr = std::max_element(u_.begin(), u_.end(), [](auto a, auto b) { return std::abs(a) < std::abs(b); });
+            auto const umax = *itr;
+            for (auto i = 1U; i < u_.size() - 1; i++) {
+                if (u_[i] * umax < -TFWIteration::NODE_TOLERANCE * umax * umax) {
+                    throw std::runtime_error("節のある解に収束しました。");
+                }
+            }
+
+            // エネルギーは電子数について凸でE(0) = 0なので、中性原子のエネルギーE(Z)からE(N) <= (N / Z)E(Z)と見積もれる
+            // （Thomas-Fermi模型のエネルギーは、λが大きいと何倍も低くなり見積もりに使えない）
+            // 中性原子を解いている間はE(Z) = 0として、束縛状態であること（E < 0）だけを確かめる
+            if (total() > TFWIteration::ENERGY_RATIO * N_ / Z_ * eneutral_) {
+                throw std::runtime_error("エネルギーが高すぎる解に収束しました。");
+            }
+        }
+
+        // #endregion privateメンバ関数
+
+        // #region 非メンバ関数
+
+        void tfwsweep(std::shared_ptr<Data> const & pdata)
+        {
+            // 電離度が省略されていたら中性原子（q = 0）を解く
+            std::vector<double> Zlist(pdata->Zlist_);
+            std::vector<double> qlist(pdata->ion_degree_);
+            if (qlist.empty()) {
+                qlist.push_back(0.0);
+            }
+
+            // 近いパラメータが続くように、原子番号、電離度の昇順に並べる
+            std::sort(Zlist.begin(), Zlist.end());
+            std::sort(qlist.begin(), qlist.end());
+
+            std::vector< std::pair<double, double> > jobs;
+            jobs.reserve(Zlist.size() * qlist.size());
+            for (auto const Z : Zlist) {
+                for (auto const q : qlist) {
+                    jobs.push_back(std::make_pair(Z, q));
+                }
+            }
+
+            auto const size = jobs.size();
+            std::vector<TFWIteration::result_type> result(size);
+
+            auto const nchain = pdata->useomp_ ? static_cast<std::size_t>(omp_get_max_threads()) : 1U;
+
+            // 一つの原子番号のすべての電離度は、スレッド数によらず同じ連鎖で、中性原子から順に解く
+            // （連鎖の途中から解き始めると、初期値が変わって結果がスレッド数に依存するため）
+            auto const nq = qlist.size();
+            utility::chainsweep(Zlist.size(), nchain, [&pdata, &jobs, &result, nq](std::size_t begin, std::size_t end) {
+                for (auto iz = begin; iz < end; iz++) {
+                    // 原子番号ごとにメッシュが変わるので作り直す
+                    TFWIteration iter(pdata, jobs[iz * nq].first);
+
+                    for (auto i = iz * nq; i < (iz + 1) * nq; i++) {
+                        auto const [Z, q] = jobs[i];
+
+                        iter.Iterationloop(q);
+                        result[i] = iter.makeresult();
+
+                        auto const filename = (boost::format("rho_tfw_Z%g_q%g.csv") % Z % q).str();
+
+                        utility::CsvWriter cw(filename);
+
+                        auto const & r(std::get<0>(result[i]));
+                        auto const & rho(std::get<1>(result[i]));
+                        for (auto j = 0U; j < r.size(); j++) {
+                            cw(r[j], rho[j]);
+                        }
+
+                        cw.close();
+                    }
+                }
+            });
+
+            std::unique_ptr<FILE, decltype(&std::fclose)> fp(std::fopen("tfw.csv", "w"), std::fclose);
+            if (!fp) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            auto const lambda = pdata->weizsacker_lambda_;
+            for (auto const Z : pdata->Zlist_) {
+                for (auto i = 0U; i < size; i++) {
+                    if (jobs[i].first != Z) {
+                        continue;
+                    }
+
+                    auto const q = jobs[i].second;
+                    auto const mu = std::get<2>(result[i]);
+                    auto const [ttf, tw, ene, eh] = std::get<3>(result[i]);
+
+                    // 運動エネルギーT = T_TF + λT_W、ポテンシャルエネルギーV = E_ne + E_H（ビリアル定理から-V / T = 2）
+                    auto const t = ttf + lambda * tw;
+                    auto const energy = t + ene + eh;
+
+                    std::fprintf(fp.get(), "%g, %g, %.15f, %.15f, %.15f, %.15f, %.15f, %.15f\n", Z, q, mu, energy, ttf, tw, ene, eh);
+                    std::cout << boost::format("Z = %g, q = %g, mu = %.15f, Energy = %.15f (Hartree), -V/T = %.15f\n") % Z % q % mu % energy % (-(ene + eh) / t);
+                }
+            }
+        }
+
+        // #endregion 非メンバ関数
+    }
+}
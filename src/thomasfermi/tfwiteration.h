@@ -0,0 +1,383 @@
+﻿/*! \file tfwiteration.h
+    \brief Thomas-Fermi-λWeizsäcker模型の方程式をNewton法で解くクラスの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef _TFWITERATION_H_
+#define _TFWITERATION_H_
+
+#pragma once
+
+#include "data.h"
+#include <array>                    // for std::array
+#include <cstdint>                  // for std::int32_t
+#include <memory>                   // for std::shared_ptr
+#include <tuple>                    // for std::tuple
+#include <vector>                   // for std::vector
+
+namespace thomasfermi {
+    namespace femall {
+        //! A class.
+        /*!
+            Thomas-Fermi-λWeizsäcker模型の方程式をNewton法で解くクラス
+            u(r) = r√(4πρ(r))、Hartreeポテンシャルをw(r) = rv_H(r)とすると、Euler-Lagrange方程式は
+            -(λ/2)u'' + [(1/2)(3π^2ρ)^(2/3) + (w - Z) / r]u = μu、w'' = -u^2 / r、∫u^2dr = N
+            という連立方程式になる（u(0) = u(R) = 0、w(0) = 0、w(R) = N）
+            これを対数メッシュ上の一次要素で離散化し、uとwを節点ごとに交互に並べると、
+            Jacobi行列は帯幅3の帯行列にμについての一行一列を付け加えた形になるので、
+            帯行列のLU分解を二つの右辺に使ってNewton法で解く
+            Jacobi行列の分解は、収束が十分に速い間は反復をまたいで使い回す
+        */
+        class TFWIteration final {
+            // #region 型エイリアス
+
+        public:
+            using energy_type = std::array<double, 4>;
+
+            using result_type = std::tuple<std::vector<double>, std::vector<double>, double, TFWIteration::energy_type>;
+
+            // #endregion 型エイリアス
+
+            // #region コンストラクタ・デストラクタ
+
+            //! A constructor.
+            /*!
+                唯一のコンストラクタ
+                \param pdata インプットファイルのデータ
+                \param Z 原子番号
+            */
+            TFWIteration(std::shared_ptr<Data> const & pdata, double Z);
+
+            //! A default destructor.
+            /*!
+                デフォルトデストラクタ
+            */
+            ~TFWIteration() = default;
+
+            // #endregion コンストラクタ・デストラクタ
+
+            // #region publicメンバ関数
+
+            //! A public member function.
+            /*!
+                電離度qの原子・イオンについて、自己無撞着な電子密度を求める
+                初めて解くときは中性原子を解いてから、それ以降は直前に解いた解から（ウォームスタート）、
+                電子数を少しずつ目標の値まで変えて解く
+                収束しないか、節のある解やエネルギーが高すぎる解にしか収束しないときはstd::runtime_errorを投げる
+                \param q 電離度（中性原子ならq = 0）
+            */
+            void Iterationloop(double q);
+
+            //! A public member function (const).
+            /*!
+                結果を返す関数
+                \return rのメッシュ、u(r)^2 = 4πr^2ρ(r)、化学ポテンシャルμ、エネルギーの各成分のstd::tuple
+            */
+            result_type makeresult() const;
+
+            // #endregion publicメンバ関数
+
+            // #region privateメンバ関数
+
+        private:
+            //! A private member function (const).
+            /*!
+                三重対角の対称行列Aについて、二次形式x^TAxを返す
+                \param a0 対角要素
+                \param a1 副対角要素
+                \param x ベクトルx
+                \return x^TAx
+            */
+            double dot(std::vector<double> const & a0, std::vector<double> const & a1, std::vector<double> const & x) const;
+
+            //! A private member function (const).
+            /*!
+                要素ごとの処理を（OpenMPを使用する場合は並列に）行う
+                \param func 要素の番号、要素の左端のr、要素の長さを引数に取る関数オブジェクト
+            */
+            template <typename Function>
+            void elementloop(Function && func) const;
+
+            //! A private member function (const).
+            /*!
+                エネルギーの各成分（T_TF、T_W、E_ne、E_H）を求める
+                全エネルギーはT_TF + λT_W + E_ne + E_H
+                \return エネルギーの各成分
+            */
+            energy_type energy() const;
+
+            //! A private member function.
+            /*!
+                現在の解についてJacobi行列を生成し、LU分解する
+            */
+            void factorize();
+
+            //! A private member function (const).
+            /*!
+                初期値のuからHartreeポテンシャルw = rv_Hを求める
+                \return Hartreeポテンシャルw = rv_H
+            */
+            std::vector<double> hartree() const;
+
+            //! A private member function (const).
+            /*!
+                三重対角の対称行列Aについて、Axを返す
+                \param a0 対角要素
+                \param a1 副対角要素
+                \param x ベクトルx
+                \return Ax
+            */
+            std::vector<double> matvec(std::vector<double> const & a0, std::vector<double> const & a1, std::vector<double> const & x) const;
+
+            //! A private member function.
+            /*!
+                現在の電子数N_について、現在のu、w、μを初期値としてNewton法で方程式を解く
+                収束しないときはstd::runtime_errorを投げる
+            */
+            void newton();
+
+            //! A private member function (const).
+            /*!
+                uを規格化し、μをRayleigh商としたときの方程式の残差を求める
+                \param u uの値（規格化される）
+                \param w wの値
+                \param mu μの値（Rayleigh商が入る）
+                \param res uとwの方程式の残差（節点ごとに交互に並べる）
+                \return 残差のノルム
+            */
+            double residual(std::vector<double> & u, std::vector<double> const & w, double & mu, std::vector<double> & res) const;
+
+            //! A private member function (const).
+            /*!
+                LU分解したJacobi行列を使って連立一次方程式を解く
+                \param b 右辺のベクトル
+                \return 連立一次方程式の解
+            */
+            std::vector<double> solve(std::vector<double> b) const;
+
+            //! A private member function (const).
+            /*!
+                現在の解の全エネルギーT_TF + λT_W + E_ne + E_Hを求める
+                \return 全エネルギー
+            */
+            double total() const;
+
+            //! A private member function (const).
+            /*!
+                収束した解が基底状態らしいかを確かめる
+                uに節があるか、全エネルギーが中性原子の解から見積もった値より高すぎるときはstd::runtime_errorを投げる
+            */
+            void validate() const;
+
+            // #endregion privateメンバ関数
+
+            // #region メンバ変数
+
+            //! A private member variable (constant expression).
+            /*!
+                Jacobi行列の帯の下側の幅（uとwを交互に並べたとき）
+            */
+            static auto constexpr KL = 3;
+
+            //! A private member variable (constant expression).
+            /*!
+                Jacobi行列の帯の上側の幅（uとwを交互に並べたとき）
+            */
+            static auto constexpr KU = 3;
+
+            //! A private member variable (constant expression).
+            /*!
+                LU分解したJacobi行列を格納する配列の1次元目の大きさ
+            */
+            static auto constexpr LDAB = 2 * TFWIteration::KL + TFWIteration::KU + 1;
+
+            //! A private member variable (constant expression).
+            /*!
+                全エネルギーがENERGY_RATIO * (N / Z) * E(Z)より高い解は、基底状態でないとみなす
+            */
+            static auto constexpr ENERGY_RATIO = 0.5;
+
+            //! A private member variable (constant expression).
+            /*!
+                直線探索の最大反復回数
+            */
+            static auto constexpr LINESEARCH_MAXITER = 30U;
+
+            //! A private member variable (constant expression).
+            /*!
+                uの絶対値の最大値に対してこの比率より大きく符号が反転していたら、節があるとみなす
+            */
+            static auto constexpr NODE_TOLERANCE = 1.0E-8;
+
+            //! A private member variable (constant expression).
+            /*!
+                電子数を変えていくときに、続けて刻み幅を半分にする最大の回数
+            */
+            static auto constexpr RAMP_MAXHALVING = 10U;
+
+            //! A private member variable (constant expression).
+            /*!
+                分解済みのJacobi行列を使い回したときに、残差がこの比率より小さくならなければ次の反復で分解し直す
+            */
+            static auto constexpr REUSE_RATIO = 0.25;
+
+            //! A private member variable.
+            /*!
+                LU分解したJacobi行列（帯行列の形式）
+            */
+            std::vector<double> ab_;
+
+            //! A private member variable.
+            /*!
+                中性原子の全エネルギー（まだ解いていなければ0）
+            */
+            double eneutral_;
+
+            //! A private member variable.
+            /*!
+                Gauss-Legendre積分の重み
+            */
+            std::vector<double> glw_;
+
+            //! A private member variable.
+            /*!
+                Gauss-Legendre積分の節
+            */
+            std::vector<double> glx_;
+
+            //! A private member variable.
+            /*!
+                LU分解のピボット
+            */
+            std::vector<std::int32_t> ipiv_;
+
+            //! A private member variable.
+            /*!
+                剛性行列∫N_i'N_j'drの対角要素
+            */
+            std::vector<double> k0_;
+
+            //! A private member variable.
+            /*!
+                剛性行列∫N_i'N_j'drの副対角要素
+            */
+            std::vector<double> k1_;
+
+            //! A private member variable (constant).
+            /*!
+                λWeizsäckerの係数λ
+            */
+            double const lambda_;
+
+            //! A private member variable.
+            /*!
+                重なり行列∫N_iN_jdrの対角要素
+            */
+            std::vector<double> m0_;
+
+            //! A private member variable.
+            /*!
+                重なり行列∫N_iN_jdrの副対角要素
+            */
+            std::vector<double> m1_;
+
+            //! A private member variable.
+            /*!
+                化学ポテンシャル（Lagrangeの未定乗数）
+            */
+            double mu_;
+
+            //! A private member variable.
+            /*!
+                電子数
+            */
+            double N_;
+
+            //! A private member variable (constant).
+            /*!
+                データオブジェクト
+            */
+            std::shared_ptr<Data> const pdata_;
+
+            //! A private member variable.
+            /*!
+                rのメッシュの可変長配列
+            */
+            std::vector<double> r_;
+
+            //! A private member variable.
+            /*!
+                u(r) = r√(4πρ(r))の値の可変長配列
+            */
+            std::vector<double> u_;
+
+            //! A private member variable.
+            /*!
+                w(r) = rv_H(r)の値の可変長配列
+            */
+            std::vector<double> w_;
+
+            //! A private member variable (constant).
+            /*!
+                原子番号
+            */
+            double const Z_;
+
+            // #endregion メンバ変数
+
+            // #region 禁止されたコンストラクタ・メンバ関数
+
+        public:
+            //! A default constructor (deleted).
+            /*!
+                デフォルトコンストラクタ（禁止）
+            */
+            TFWIteration() = delete;
+
+            //! A copy constructor (deleted).
+            /*!
+                コピーコンストラクタ（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+            */
+            TFWIteration(TFWIteration const & dummy) = delete;
+
+            //! A public member function (deleted).
+            /*!
+                operator=()の宣言（禁止）
+                \param dummy コピー元のオブジェクト（未使用）
+                \return コピー元のオブジェクト
+            */
+            TFWIteration & operator=(TFWIteration const & dummy) = delete;
+
+            // #endregion 禁止されたコンストラクタ・メンバ関数
+        };
+
+        // #region 非メンバ関数
+
+        //! A function.
+        /*!
+            原子番号と電離度のリストについてThomas-Fermi-λWeizsäcker模型の解を求め、結果をファイルに出力する
+            原子番号ごとの連鎖をいくつかのタスクに分け、一つの原子番号の電離度は昇順に、直前の解を初期値として順に解く
+            \param pdata インプットファイルのデータ
+        */
+        void tfwsweep(std::shared_ptr<Data> const & pdata);
+
+        // #endregion 非メンバ関数
+    }
+}
+
+#endif  // _TFWITERATION_H_
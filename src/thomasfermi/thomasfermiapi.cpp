@@ -0,0 +1,263 @@
+﻿/*! \file thomasfermiapi.cpp
+    \brief Cから（FFIで）ソルバーを使うための関数の実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "solver.h"
+#include "thomasfermiapi.h"
+#include "../alglib/src/ap.h"   // for alglib::ap_error
+#include <algorithm>    // for std::copy
+#include <memory>       // for std::make_shared, std::shared_ptr
+#include <new>          // for std::bad_alloc
+#include <stdexcept>    // for std::exception, std::invalid_argument, std::logic_error, std::runtime_error
+#include <string>       // for std::string
+
+//! A struct.
+/*!
+    Cに見せるソルバーのハンドルの中身
+*/
+struct tf_solver final {
+    //! A constructor.
+    /*!
+        唯一のコンストラクタ
+        \param pdata 計算の設定
+    */
+    explicit tf_solver(std::shared_ptr<thomasfermi::Data> const & pdata)
+        :   solver(pdata)
+    {
+    }
+
+    //! A public member variable.
+    /*!
+        ソルバー
+    */
+    thomasfermi::Solver solver;
+};
+
+namespace thomasfermi {
+    namespace api {
+        // #region 非メンバ関数
+
+        //! A function.
+        /*!
+            スレッドごとの、最後に失敗した関数のエラーメッセージを返す
+            \return エラーメッセージ
+        */
+        std::string & lasterror()
+        {
+            thread_local std::string message;
+            return message;
+        }
+
+        //! A function.
+        /*!
+            エラーメッセージを記録して、関数の戻り値を返す
+            \param status 関数の戻り値
+            \param message エラーメッセージ
+            \return 関数の戻り値
+        */
+        int seterror(tf_status status, char const * message) noexcept
+        {
+            try {
+                lasterror() = message;
+            }
+            catch (std::bad_alloc const &) {
+            }
+
+            return status;
+        }
+
+        template <typename Function>
+        //! A template function（非メンバ関数）.
+        /*!
+            関数を呼び出し、C++の例外を関数の戻り値に変換する
+            \param func 呼び出す関数
+            \return 関数の戻り値
+        */
+        int invoke(Function && func) noexcept
+        {
+            try {
+                func();
+            }
+            catch (std::bad_alloc const &) {
+                return seterror(TF_ERROR_NO_MEMORY, "メモリ確保に失敗しました。");
+            }
+            catch (std::invalid_argument const & e) {
+                return seterror(TF_ERROR_INVALID_ARGUMENT, e.what());
+            }
+            catch (std::logic_error const & e) {
+                return seterror(TF_ERROR_NOT_SOLVED, e.what());
+            }
+            catch (std::runtime_error const & e) {
+                return seterror(TF_ERROR_NOT_CONVERGED, e.what());
+            }
+            catch (std::exception const & e) {
+                return seterror(TF_ERROR_UNKNOWN, e.what());
+            }
+            catch (alglib::ap_error const & e) {
+                // alglibの例外はstd::exceptionから派生していない
+                return seterror(TF_ERROR_UNKNOWN, e.msg.c_str());
+            }
+            catch (...) {
+                // どんな例外もホストのプロセスには投げ返さない
+                return seterror(TF_ERROR_UNKNOWN, "予期しない例外が発生しました。");
+            }
+
+            return TF_OK;
+        }
+
+        //! A function.
+        /*!
+            Cの計算の設定から、Data構造体を作る
+            \param param Cの計算の設定（nullptrならデフォルト値）
+            \return Data構造体
+        */
+        std::shared_ptr<Data> makedata(tf_parameters const * param)
+        {
+            auto const pdata = std::make_shared<Data>();
+            if (param) {
+                pdata->eps_ = param->eps;
+                pdata->gauss_legendre_integ_ = param->gauss_legendre_integ;
+                pdata->grid_num_ = param->grid_num;
+                pdata->iteration_criterion_ = param->iteration_criterion;
+                pdata->iteration_maxiter_ = param->iteration_maxiter;
+                pdata->iteration_mixing_weight_ = param->iteration_mixing_weight;
+                pdata->match_point_ = param->match_point;
+                pdata->useomp_ = param->useomp != 0;
+                pdata->xmax_ = param->xmax;
+                pdata->xmin_ = param->xmin;
+            }
+
+            return pdata;
+        }
+
+        // #endregion 非メンバ関数
+    }
+}
+
+extern "C" {
+    void tf_parameters_default(tf_parameters * param)
+    {
+        if (!param) {
+            return;
+        }
+
+        thomasfermi::Data const data{};
+        param->eps = data.eps_;
+        param->gauss_legendre_integ = data.gauss_legendre_integ_;
+        param->grid_num = data.grid_num_;
+        param->iteration_criterion = data.iteration_criterion_;
+        param->iteration_maxiter = data.iteration_maxiter_;
+        param->iteration_mixing_weight = data.iteration_mixing_weight_;
+        param->match_point = data.match_point_;
+        param->useomp = data.useomp_ ? 1 : 0;
+        param->xmax = data.xmax_;
+        param->xmin = data.xmin_;
+    }
+
+    tf_solver * tf_solver_create(tf_parameters const * param)
+    {
+        tf_solver * solver = nullptr;
+        thomasfermi::api::invoke([param, &solver] { solver = new tf_solver(thomasfermi::api::makedata(param)); });
+
+        return solver;
+    }
+
+    void tf_solver_destroy(tf_solver * solver)
+    {
+        delete solver;
+    }
+
+    int tf_solver_configure(tf_solver * solver, tf_parameters const * param)
+    {
+        if (!solver || !param) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "引数がNULLです。");
+        }
+
+        return thomasfermi::api::invoke([solver, param] { solver->solver.setdata(thomasfermi::api::makedata(param)); });
+    }
+
+    int tf_solver_solve(tf_solver * solver, unsigned int * niter)
+    {
+        if (!solver) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "引数がNULLです。");
+        }
+
+        return thomasfermi::api::invoke([solver, niter] {
+            auto const iter = solver->solver.solve();
+            if (niter) {
+                *niter = iter;
+            }
+        });
+    }
+
+    size_t tf_solver_size(tf_solver const * solver)
+    {
+        return solver ? solver->solver.size() : 0;
+    }
+
+    int tf_solver_get_y(tf_solver const * solver, double * x, double * y, size_t n, double * yprime0)
+    {
+        if (!solver) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "引数がNULLです。");
+        }
+
+        if ((x || y) && n < solver->solver.size()) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "配列の要素数が足りません。");
+        }
+
+        return thomasfermi::api::invoke([solver, x, y, yprime0] {
+            solver->solver.y(x, y);
+            if (yprime0) {
+                *yprime0 = solver->solver.yprime0();
+            }
+        });
+    }
+
+    int tf_solver_get_energy(tf_solver const * solver, double Z, double * energy)
+    {
+        if (!solver || !energy) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "引数がNULLです。");
+        }
+
+        if (!(Z > 0.0)) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "原子番号は正の値でなければなりません。");
+        }
+
+        return thomasfermi::api::invoke([solver, Z, energy] {
+            auto const e = solver->solver.energy(Z);
+            std::copy(e.begin(), e.end(), energy);
+        });
+    }
+
+    int tf_solver_get_density(tf_solver const * solver, double Z, double const * r, double * rho, size_t n)
+    {
+        if (!solver || ((!r || !rho) && n)) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "引数がNULLです。");
+        }
+
+        if (!(Z > 0.0)) {
+            return thomasfermi::api::seterror(TF_ERROR_INVALID_ARGUMENT, "原子番号は正の値でなければなりません。");
+        }
+
+        return thomasfermi::api::invoke([solver, Z, r, rho, n] { solver->solver.density(Z, r, rho, n); });
+    }
+
+    char const * tf_last_error(void)
+    {
+        return thomasfermi::api::lasterror().c_str();
+    }
+}
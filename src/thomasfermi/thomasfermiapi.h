@@ -0,0 +1,147 @@
+﻿/*! \file thomasfermiapi.h
+    \brief Cから（FFIで）ソルバーを使うための関数の宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _THOMASFERMIAPI_H_
+#define _THOMASFERMIAPI_H_
+
+#pragma once
+
+#include <stddef.h>     /* for size_t */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*!
+        関数の戻り値（0なら成功）
+    */
+    enum tf_status {
+        TF_OK = 0,                      /*!< 成功 */
+        TF_ERROR_INVALID_ARGUMENT = 1,  /*!< 引数が正しくない */
+        TF_ERROR_NOT_SOLVED = 2,        /*!< まだ方程式を解いていない */
+        TF_ERROR_NOT_CONVERGED = 3,     /*!< 方程式の解が収束しなかった */
+        TF_ERROR_NO_MEMORY = 4,         /*!< メモリ確保に失敗した */
+        TF_ERROR_UNKNOWN = 5            /*!< 上記以外のエラー（詳しくはtf_last_error()） */
+    };
+
+    /*!
+        計算の設定（thomasfermi::Data構造体のうち、孤立した中性原子を解くのに使う値）
+    */
+    struct tf_parameters {
+        double eps;                     /*!< 微分方程式を解くときの許容誤差 */
+        unsigned int gauss_legendre_integ; /*!< Gauss-Legendre積分の分点 */
+        unsigned int grid_num;          /*!< 微分方程式を解くときのメッシュの数 */
+        double iteration_criterion;     /*!< ITERATIONの収束判定条件の値 */
+        unsigned int iteration_maxiter; /*!< ITERATIONの最大ループ回数 */
+        double iteration_mixing_weight; /*!< 電子密度を合成するときの重み */
+        double match_point;             /*!< マッチングポイント */
+        int useomp;                     /*!< OpenMPを使用するかどうか（0なら使用しない） */
+        double xmax;                    /*!< 微分方程式を解くときのメッシュの最大値 */
+        double xmin;                    /*!< 微分方程式を解くときのメッシュの最小値 */
+    };
+
+    /*!
+        ソルバーのハンドル（中身は見せない）
+    */
+    typedef struct tf_solver tf_solver;
+
+    /*!
+        計算の設定をデフォルト値で初期化する
+        \param param 初期化する設定
+    */
+    void tf_parameters_default(struct tf_parameters * param);
+
+    /*!
+        ソルバーを生成する
+        \param param 計算の設定（NULLならデフォルト値）
+        \return 生成したソルバー（設定が正しくないときやメモリ確保に失敗したときはNULL）
+    */
+    tf_solver * tf_solver_create(struct tf_parameters const * param);
+
+    /*!
+        ソルバーを破棄する
+        \param solver 破棄するソルバー（NULLなら何もしない）
+    */
+    void tf_solver_destroy(tf_solver * solver);
+
+    /*!
+        ソルバーの設定を変える（直前の解は、次のtf_solver_solveの初期関数に使う）
+        \param solver ソルバー
+        \param param 新しい計算の設定
+        \return 関数の戻り値
+    */
+    int tf_solver_configure(tf_solver * solver, struct tf_parameters const * param);
+
+    /*!
+        Thomas-Fermi方程式を解く
+        \param solver ソルバー
+        \param niter 収束するまでの反復回数を書き込む先（NULLなら書き込まない）
+        \return 関数の戻り値
+    */
+    int tf_solver_solve(tf_solver * solver, unsigned int * niter);
+
+    /*!
+        メッシュの節点の数を返す
+        \param solver ソルバー
+        \return メッシュの節点の数（解いていなければ0）
+    */
+    size_t tf_solver_size(tf_solver const * solver);
+
+    /*!
+        x方向のメッシュと収束したy(x)を書き込む
+        \param solver ソルバー
+        \param x x方向のメッシュを書き込む配列（NULLなら書き込まない）
+        \param y y(x)を書き込む配列（NULLなら書き込まない）
+        \param n 配列の要素数（tf_solver_size以上でなければならない）
+        \param yprime0 原点におけるyの微分値を書き込む先（NULLなら書き込まない）
+        \return 関数の戻り値
+    */
+    int tf_solver_get_y(tf_solver const * solver, double * x, double * y, size_t n, double * yprime0);
+
+    /*!
+        原子番号Zの原子のエネルギーを書き込む
+        \param solver ソルバー
+        \param Z 原子番号
+        \param energy 運動エネルギー、電子-原子核、電子間の相互作用エネルギー（Hartree）を書き込む、要素数3の配列
+        \return 関数の戻り値
+    */
+    int tf_solver_get_energy(tf_solver const * solver, double Z, double * energy);
+
+    /*!
+        原子番号Zの原子の、n個の半径における電子密度を書き込む
+        解いた後は、一つのソルバーに複数のスレッドから同時に呼んでもよい
+        \param solver ソルバー
+        \param Z 原子番号
+        \param r 原点からの距離（原子単位、正の値）の配列
+        \param rho 電子密度を書き込む配列
+        \param n 配列の要素数
+        \return 関数の戻り値（rに負の値かNaNが含まれているときはTF_ERROR_INVALID_ARGUMENT）
+    */
+    int tf_solver_get_density(tf_solver const * solver, double Z, double const * r, double * rho, size_t n);
+
+    /*!
+        呼び出したスレッドで最後に失敗した関数のエラーメッセージを返す
+        \return エラーメッセージ（UTF-8、そのスレッドで次に関数が失敗するまで有効）
+    */
+    char const * tf_last_error(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  /* _THOMASFERMIAPI_H_ */
@@ -17,10 +17,16 @@
 */
 
 #include "../checkpoint/checkpoint.h"
+#include "../checkpoint/profiler.h"
 #include "getcomlineoption.h"
 #include "goexit.h"
+#include "ioniteration.h"
 #include "iteration.h"
 #include "makerhoen/makerhoenergy.h"
+#include "readinputfile.h"
+#include "scalingstudy.h"
+#include "server.h"
+#include "tfwiteration.h"
 #include <cstdlib>                      // for EXIT_FAILURE, EXIT_SUCCESS
 #include <iostream>                     // for std::cerr
 
@@ -50,19 +56,111 @@ int main(int argc, char * argv[])
         break;
     }
 
-    cp.checkpoint("処理開始", __LINE__);
-    try {
-        thomasfermi::femall::Iteration iter(mg.getpairdata());
+    if (auto const & serve = mg.getserve()) {
+        // サーバーとして動作するときは、インプットファイルを読まずにジョブを受け付ける
+        try {
+            thomasfermi::Server(std::get<1>(mg.getpairdata())).run(*serve);
+        } catch (std::runtime_error const & e) {
+            std::cerr << e.what() << std::endl;
+
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
 
-        cp.checkpoint("初期関数生成処理", __LINE__);
+    if (auto const & study = mg.getscalingstudy()) {
+        // スケーリングの測定では、インプットファイルを読まずにデフォルト値の問題を解く
+        try {
+            thomasfermi::ScalingStudy(mg.getscalinggridmax()).run(*study);
+        } catch (std::runtime_error const & e) {
+            std::cerr << e.what() << std::endl;
 
-        iter.Iterationloop();
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
 
-        cp.checkpoint("Iterationループ処理", __LINE__);
-        thomasfermi::makerhoen::MakeRhoEnergy mre(iter.PData()->gauss_legendre_integ_norm_, iter.makeresult(), iter.PData()->Z_);
-        mre.saveresult();
+    // 計測はOpenMPのスレッドが生成される前に有効にする（ハードウェアカウンタがスレッドに引き継がれるように）
+    auto const & profile = mg.getprofile();
+    if (profile || mg.getcounters()) {
+        checkpoint::Profiler::instance().enable(mg.getcounters());
+    }
 
-        cp.checkpoint("結果出力処理", __LINE__);
+    cp.checkpoint("処理開始", __LINE__);
+    try {
+        // インプットファイルの読み込み
+        thomasfermi::ReadInputFile rif(mg.getpairdata());
+        rif.readFile();
+        auto const & pdata = rif.PData();
+        pdata->restart_ = mg.getrestart();
+
+        cp.checkpoint("インプットファイル読み込み処理", __LINE__);
+
+        if (pdata->model_ == thomasfermi::Model::TFD) {
+            // Thomas-Fermi-Dirac模型では、原子・イオンは常に有限の半径を持つ
+            thomasfermi::femall::ionsweep<thomasfermi::femall::TFDSource>(pdata);
+
+            cp.checkpoint("Thomas-Fermi-Dirac模型の計算処理", __LINE__);
+        }
+        else if (!pdata->temperature_.empty()) {
+            // 有限温度では、原子をセルに閉じ込めて、温度と密度ごとに解く
+            thomasfermi::femall::cellsweep<thomasfermi::femall::FTSource>(pdata);
+
+            cp.checkpoint("有限温度の計算処理", __LINE__);
+        }
+        else if (!pdata->cell_density_.empty()) {
+            // 絶対零度では、原子をセルに閉じ込めて、密度ごとに圧力とエネルギーを求める
+            thomasfermi::femall::cellsweep<thomasfermi::femall::TFSource>(pdata);
+
+            cp.checkpoint("状態方程式の計算処理", __LINE__);
+        }
+        else if (pdata->model_ == thomasfermi::Model::TFW) {
+            // Thomas-Fermi-λWeizsäcker模型では、電子密度を固有値問題として解く
+            thomasfermi::femall::tfwsweep(pdata);
+
+            cp.checkpoint("Thomas-Fermi-λWeizsäcker模型の計算処理", __LINE__);
+        }
+        else if (!pdata->ion_degree_.empty()) {
+            // イオンモードでは、電離度ごとにイオンの半径とy(x)を求めて結果を出力する
+            thomasfermi::femall::ionsweep<thomasfermi::femall::TFSource>(pdata);
+
+            cp.checkpoint("イオンの計算処理", __LINE__);
+        }
+        else if (!pdata->sweep_grid_num_.empty()) {
+            // パラメータスイープでは、全ての組み合わせを一つのプロセスで解いて、結果を一つの表にまとめる
+            thomasfermi::femall::paramsweep(pdata);
+
+            cp.checkpoint("パラメータスイープの計算処理", __LINE__);
+        }
+        else {
+            thomasfermi::femall::Iteration iter = [&pdata] {
+                checkpoint::ScopedTimer timer("initialize");
+                return thomasfermi::femall::Iteration(pdata);
+            }();
+
+            cp.checkpoint("初期関数生成処理", __LINE__);
+
+            {
+                checkpoint::ScopedTimer timer("iterationloop");
+                iter.Iterationloop(true);
+            }
+
+            cp.checkpoint("Iterationループ処理", __LINE__);
+
+            checkpoint::ScopedTimer timer("output");
+            if (pdata->Zlist_.size() > 1) {
+                // バッチモードでは、y(x)を一度だけ解いて原子番号ごとに結果を出力する
+                thomasfermi::makerhoen::saveresultbatch(pdata->gauss_legendre_integ_, iter.makeresult(), pdata->Zlist_, pdata->useomp_, pdata->output_binary_, pdata->output_tolerance_);
+            }
+            else {
+                thomasfermi::makerhoen::MakeRhoEnergy mre(pdata->gauss_legendre_integ_, iter.makeresult(), pdata->Z_, pdata->useomp_);
+                mre.saveresult(pdata->output_binary_, pdata->output_tolerance_);
+            }
+
+            cp.checkpoint("結果出力処理", __LINE__);
+        }
     } catch (std::bad_alloc const &) {
         std::cerr << "メモリ確保に失敗しました。強制終了します。" << std::endl;
         thomasfermi::goexit();
@@ -86,6 +184,19 @@ int main(int argc, char * argv[])
     cp.totalpassageoftime();
     checkpoint::usedmem();
 
+    auto const & profiler = checkpoint::Profiler::instance();
+    if (profiler.enabled()) {
+        profiler.print();
+    }
+
+    if (profile) {
+        try {
+            profiler.save(*profile);
+        } catch (std::runtime_error const & e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
     thomasfermi::goexit();
 
     return EXIT_SUCCESS;
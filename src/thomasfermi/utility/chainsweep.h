@@ -0,0 +1,87 @@
+﻿/*! \file chainsweep.h
+    \brief パラメータのリストを複数の連鎖に分けて並列に処理する関数の宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CHAINSWEEP_H_
+#define _CHAINSWEEP_H_
+
+#pragma once
+
+#include <algorithm>    // for std::clamp
+#include <cstddef>      // for std::size_t
+#include <exception>    // for std::exception_ptr, std::current_exception, std::rethrow_exception
+#include <vector>       // for std::vector
+
+namespace utility {
+    template <typename Function>
+    //! A template function.
+    /*!
+        [0, njob)のジョブをnchain個の連続した区間に分け、区間ごとに一つのタスクで実行する
+        一つの区間の中では、ジョブは添字の順に逐次実行されるので、
+        前のジョブの解を次のジョブの初期値に使う（ウォームスタート）ことができる
+        \param njob ジョブの数
+        \param nchain 区間（連鎖）の数
+        \param func 区間[begin, end)を処理する関数オブジェクト
+    */
+    void chainsweep(std::size_t njob, std::size_t nchain, Function && func)
+    {
+        if (!njob) {
+            return;
+        }
+
+        nchain = std::clamp<std::size_t>(nchain, 1, njob);
+
+        // 各区間で発生した例外
+        std::vector<std::exception_ptr> error(nchain);
+
+        auto const run = [njob, nchain, &func, &error](std::size_t ichain) {
+            auto const begin = njob * ichain / nchain;
+            auto const end = njob * (ichain + 1) / nchain;
+
+            try {
+                func(begin, end);
+            }
+            catch (...) {
+                error[ichain] = std::current_exception();
+            }
+        };
+
+        if (nchain > 1) {
+#if _OPENMP >= 200805
+    #pragma omp parallel    // OpenMP並列領域の始まり
+    #pragma omp single      // task句はsingle領域で実行
+#endif
+            for (auto i = 0U; i < nchain; i++) {
+#if _OPENMP >= 200805
+    #pragma omp task firstprivate(i)
+#endif
+                run(i);
+            }
+        }
+        else {
+            run(0);
+        }
+
+        for (auto && e : error) {
+            if (e) {
+                std::rethrow_exception(e);
+            }
+        }
+    }
+}
+
+#endif  // _CHAINSWEEP_H_
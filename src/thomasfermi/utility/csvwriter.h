@@ -0,0 +1,234 @@
+﻿/*! \file csvwriter.h
+    \brief 数値の表を大きなバッファにまとめてCSVファイルに書き出すクラスの宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _CSVWRITER_H_
+#define _CSVWRITER_H_
+
+#pragma once
+
+#include <charconv>     // for std::chars_format, std::to_chars
+#include <cstddef>      // for std::size_t
+#include <cstdio>       // for FILE, std::fclose, std::fopen, std::fwrite, std::setvbuf
+#include <memory>       // for std::unique_ptr
+#include <stdexcept>    // for std::runtime_error
+#include <string>       // for std::string
+#include <vector>       // for std::vector
+
+namespace utility {
+    //! A class.
+    /*!
+        一行分の数値を「%.15f, %.15f, ...」と同じ書式で文字列にしてバッファに溜め、
+        バッファが一杯になったら一度のfwriteでファイルに書き出すクラス
+        数値の変換にはロケールに依存しないstd::to_charsを使う
+    */
+    class CsvWriter final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            ファイルを開いて書き出すコンストラクタ
+            \param filename 書き出すファイル名
+        */
+        explicit CsvWriter(std::string const & filename)
+            :   buf_(CsvWriter::BUFSIZE),
+                fp_(std::fopen(filename.c_str(), "w"), std::fclose),
+                pos_(0)
+        {
+            if (!fp_) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            // 自前のバッファで十分に大きな塊にしてから書くので、stdioのバッファは使わない
+            std::setvbuf(fp_.get(), nullptr, _IONBF, 0);
+        }
+
+        //! A constructor.
+        /*!
+            開いているファイルポインタ（標準出力やソケットなど）に書き出すコンストラクタ
+            ファイルポインタは閉じない（close()もバッファを書き出すだけ）ので、書き出した後のfflushは呼び出し側で行う
+            \param fp 書き出すファイルポインタ
+        */
+        explicit CsvWriter(FILE * fp)
+            :   buf_(CsvWriter::BUFSIZE),
+                fp_(fp, [](FILE *) noexcept { return 0; }),
+                pos_(0)
+        {
+        }
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            close()を呼ばずに破棄されたときは、バッファに残った文字列を書き出して閉じるが、失敗しても例外は投げない
+        */
+        ~CsvWriter()
+        {
+            if (fp_) {
+                // 例外で抜けてきたときなどなので、書き込みの失敗はもう報告できない
+                std::fwrite(buf_.data(), 1, pos_, fp_.get());
+            }
+        }
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        template <typename... Args>
+        //! A public member function (template function).
+        /*!
+            数値を「, 」で区切った一行を書き込む
+            \param values 一行分の数値
+        */
+        void operator()(Args... values)
+        {
+            // 一行分が必ず収まるだけの空きを作っておく
+            if (pos_ + sizeof...(Args) * CsvWriter::MAXLENGTH > buf_.size()) {
+                flush();
+            }
+
+            auto first = true;
+            ((append(static_cast<double>(values), first), first = false), ...);
+
+            buf_[pos_++] = '\n';
+        }
+
+        //! A public member function.
+        /*!
+            バッファに残った文字列を書き出して、ファイルを閉じる
+            書き込みか、ファイルを閉じるのに失敗したときはstd::runtime_errorを投げる
+            呼び出した後は、もう書き込めない
+        */
+        void close()
+        {
+            flush();
+
+            auto * const fp = fp_.release();
+            if (fp_.get_deleter()(fp)) {
+                throw std::runtime_error("ファイルを閉じられませんでした。");
+            }
+        }
+
+        //! A public member function.
+        /*!
+            バッファに溜まった文字列をファイルに書き出す
+            書き込みに失敗したときはstd::runtime_errorを投げる
+        */
+        void flush()
+        {
+            if (pos_) {
+                auto const n = pos_;
+                pos_ = 0;
+                if (std::fwrite(buf_.data(), 1, n, fp_.get()) != n) {
+                    throw std::runtime_error("ファイルに書き込めませんでした。");
+                }
+            }
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private member function.
+        /*!
+            一つの数値を小数点以下PRECISION桁の固定小数点表記で書き込む
+            \param value 数値
+            \param first 行の最初の数値かどうか
+        */
+        void append(double value, bool first)
+        {
+            if (!first) {
+                buf_[pos_++] = ',';
+                buf_[pos_++] = ' ';
+            }
+
+            auto * const last = buf_.data() + buf_.size();
+            pos_ = static_cast<std::size_t>(std::to_chars(buf_.data() + pos_, last, value, std::chars_format::fixed, CsvWriter::PRECISION).ptr - buf_.data());
+        }
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable (constant expression).
+        /*!
+            バッファのサイズ（1MiB）
+        */
+        static std::size_t constexpr BUFSIZE = 1U << 20;
+
+        //! A private member variable (constant expression).
+        /*!
+            一つの数値を書き込むのに必要な最大の文字数（符号、整数部309桁、小数点、小数部、区切り）
+        */
+        static std::size_t constexpr MAXLENGTH = 352U;
+
+        //! A private member variable (constant expression).
+        /*!
+            小数点以下の桁数
+        */
+        static auto constexpr PRECISION = 15;
+
+        //! A private member variable.
+        /*!
+            書き出す前の文字列を溜めておくバッファ
+        */
+        std::vector<char> buf_;
+
+        //! A private member variable.
+        /*!
+            ファイルポインタ
+        */
+        std::unique_ptr<FILE, decltype(&std::fclose)> fp_;
+
+        //! A private member variable.
+        /*!
+            バッファの使用済みの文字数
+        */
+        std::size_t pos_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        CsvWriter() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        CsvWriter(CsvWriter const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        CsvWriter & operator=(CsvWriter const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _CSVWRITER_H_
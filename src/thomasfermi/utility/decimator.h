@@ -0,0 +1,258 @@
+﻿/*! \file decimator.h
+    \brief 表の行を、線形補間で元の値を許容誤差以内に再現できるだけ間引くクラスの宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _DECIMATOR_H_
+#define _DECIMATOR_H_
+
+#pragma once
+
+#include <algorithm>    // for std::max, std::min
+#include <array>        // for std::array
+#include <cmath>        // for std::fabs
+#include <cstddef>      // for std::size_t
+#include <limits>       // for std::numeric_limits
+
+namespace utility {
+    template <std::size_t N>
+    //! A template class.
+    /*!
+        xの昇順に一行ずつ与えられるN列の値を、一度だけ走査して間引くクラス
+        残した行の間を線形補間したとき、間引いた行のすべての列の値が
+        相対誤差tolerance以内（|補間値 - 値| <= tolerance * |値|）で再現される
+        最後に残した行から見た傾きの許容範囲を列ごとに持ち、範囲が空になる直前の行を残す
+    */
+    class Decimator final {
+        // #region 型エイリアス
+
+    public:
+        using value_type = std::array<double, N>;
+
+        // #endregion 型エイリアス
+
+        // #region コンストラクタ・デストラクタ
+
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            \param tolerance 許容する相対誤差
+        */
+        explicit Decimator(double tolerance)
+            :   anchor_(),
+                anchorx_(0.0),
+                count_(0),
+                hi_(),
+                last_(),
+                lastx_(0.0),
+                lo_(),
+                tolerance_(tolerance)
+        {
+        }
+
+        //! A default destructor.
+        /*!
+            デフォルトデストラクタ
+        */
+        ~Decimator() = default;
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        template <typename Function>
+        //! A public member function (template function).
+        /*!
+            次の行を与え、残すことが確定した行があればemitに渡す
+            \param x 行のx（直前の行より大きくなければならない）
+            \param v 行の値
+            \param emit 残す行を受け取る関数（引数はxと値）
+        */
+        void operator()(double x, value_type const & v, Function && emit)
+        {
+            if (!count_) {
+                // 最初の行は必ず残す
+                emit(x, v);
+                setanchor(x, v);
+                count_ = 1;
+                return;
+            }
+
+            if (count_ > 1 && !isreachable(x, v)) {
+                // 直前の行までしか一本の直線で近似できないので、直前の行を残して起点にする
+                emit(lastx_, last_);
+                setanchor(lastx_, last_);
+            }
+
+            narrow(x, v);
+            lastx_ = x;
+            last_ = v;
+            count_ = 2;
+        }
+
+        template <typename Function>
+        //! A public member function (template function).
+        /*!
+            最後の行を残して、走査を終える
+            \param emit 残す行を受け取る関数（引数はxと値）
+        */
+        void finish(Function && emit)
+        {
+            if (count_ > 1) {
+                emit(lastx_, last_);
+            }
+
+            count_ = 0;
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private member function (const).
+        /*!
+            起点からxまでを一本の直線で結んだとき、その間の行がすべて許容範囲に入るかどうか
+            \param x 行のx
+            \param v 行の値
+            \return 許容範囲に入るかどうか
+        */
+        bool isreachable(double x, value_type const & v) const noexcept
+        {
+            auto const dx = x - anchorx_;
+            for (auto i = 0U; i < N; i++) {
+                auto const slope = (v[i] - anchor_[i]) / dx;
+                if (slope < lo_[i] || slope > hi_[i]) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        //! A private member function.
+        /*!
+            行の許容範囲を、起点からの傾きの範囲に加える
+            \param x 行のx
+            \param v 行の値
+        */
+        void narrow(double x, value_type const & v) noexcept
+        {
+            auto const dx = x - anchorx_;
+            for (auto i = 0U; i < N; i++) {
+                auto const width = tolerance_ * std::fabs(v[i]);
+                lo_[i] = std::max(lo_[i], (v[i] - width - anchor_[i]) / dx);
+                hi_[i] = std::min(hi_[i], (v[i] + width - anchor_[i]) / dx);
+            }
+        }
+
+        //! A private member function.
+        /*!
+            起点を設定し、傾きの範囲を初期化する
+            \param x 起点のx
+            \param v 起点の値
+        */
+        void setanchor(double x, value_type const & v) noexcept
+        {
+            anchorx_ = x;
+            anchor_ = v;
+            lo_.fill(-std::numeric_limits<double>::infinity());
+            hi_.fill(std::numeric_limits<double>::infinity());
+        }
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            起点の値
+        */
+        value_type anchor_;
+
+        //! A private member variable.
+        /*!
+            起点のx
+        */
+        double anchorx_;
+
+        //! A private member variable.
+        /*!
+            まだ行がないとき0、起点だけのとき1、起点の後に行があるとき2
+        */
+        int count_;
+
+        //! A private member variable.
+        /*!
+            起点からの傾きの上限
+        */
+        value_type hi_;
+
+        //! A private member variable.
+        /*!
+            直前の行の値
+        */
+        value_type last_;
+
+        //! A private member variable.
+        /*!
+            直前の行のx
+        */
+        double lastx_;
+
+        //! A private member variable.
+        /*!
+            起点からの傾きの下限
+        */
+        value_type lo_;
+
+        //! A private member variable (constant).
+        /*!
+            許容する相対誤差
+        */
+        double const tolerance_;
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        Decimator() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        Decimator(Decimator const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        Decimator & operator=(Decimator const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _DECIMATOR_H_
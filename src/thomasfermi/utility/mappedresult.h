@@ -0,0 +1,301 @@
+﻿/*! \file mappedresult.h
+    \brief 計算結果のバイナリファイルをメモリマップして、列をコピーせずに読むクラスの宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _MAPPEDRESULT_H_
+#define _MAPPEDRESULT_H_
+
+#pragma once
+
+#include "resultformat.h"
+#include <cstddef>          // for std::size_t
+#include <cstring>          // for std::memchr
+#include <stdexcept>        // for std::runtime_error
+#include <string>           // for std::string
+#include <string_view>      // for std::string_view
+
+#ifdef _WIN32
+    #include <windows.h>    // for CreateFileA, CreateFileMappingA, MapViewOfFile, UnmapViewOfFile
+#else
+    #include <fcntl.h>      // for open
+    #include <sys/mman.h>   // for mmap, munmap
+    #include <sys/stat.h>   // for fstat
+    #include <unistd.h>     // for close
+#endif
+
+namespace utility {
+    //! A class.
+    /*!
+        計算結果のバイナリファイル（resultformat.hの形式）を読み込み専用でメモリマップし、
+        ヘッダ、列の名前、各列の先頭へのポインタを返すクラス
+        このヘッダだけをインクルードすれば、他のプログラムからも使える
+    */
+    class MappedResult final {
+        // #region コンストラクタ・デストラクタ
+
+    public:
+        //! A constructor.
+        /*!
+            唯一のコンストラクタ
+            ファイルをメモリマップし、ヘッダを検査する
+            \param filename 読み込むファイル名
+        */
+        explicit MappedResult(std::string const & filename)
+        {
+#ifdef _WIN32
+            file_ = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            LARGE_INTEGER size;
+            GetFileSizeEx(file_, &size);
+            length_ = static_cast<std::size_t>(size.QuadPart);
+
+            mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            addr_ = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+#else
+            auto const fd = open(filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("ファイルが開けませんでした。");
+            }
+
+            struct stat st;
+            fstat(fd, &st);
+            length_ = static_cast<std::size_t>(st.st_size);
+
+            addr_ = length_ ? mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            if (addr_ == MAP_FAILED) {
+                addr_ = nullptr;
+            }
+
+            // マップした後はファイル記述子は要らない
+            close(fd);
+#endif
+            if (!addr_) {
+                release();
+                throw std::runtime_error("ファイルをメモリマップできませんでした。");
+            }
+
+            if (!isvalid()) {
+                release();
+                throw std::runtime_error("計算結果のバイナリファイルではありません。");
+            }
+        }
+
+        //! A destructor.
+        /*!
+            デストラクタ
+            メモリマップを解除する
+        */
+        ~MappedResult()
+        {
+            release();
+        }
+
+        // #endregion コンストラクタ・デストラクタ
+
+        // #region publicメンバ関数
+
+        //! A public member function (const).
+        /*!
+            i番目の列の先頭へのポインタを返す
+            \param i 列の番号
+            \return i番目の列の先頭（nrow個のdouble）
+        */
+        double const * column(std::size_t i) const noexcept
+        {
+            return reinterpret_cast<double const *>(bytes() + header().offset + i * header().stride);
+        }
+
+        //! A public member function (const).
+        /*!
+            名前がnameの列の先頭へのポインタを返す
+            \param name 列の名前
+            \return 名前がnameの列の先頭（見つからなければnullptr）
+        */
+        double const * column(std::string_view name) const noexcept
+        {
+            for (auto i = 0U; i < header().ncolumn; i++) {
+                if (this->name(i) == name) {
+                    return column(i);
+                }
+            }
+
+            return nullptr;
+        }
+
+        //! A public member function (const).
+        /*!
+            ヘッダを返す
+            \return ファイルの先頭のヘッダ
+        */
+        ResultHeader const & header() const noexcept
+        {
+            return *reinterpret_cast<ResultHeader const *>(addr_);
+        }
+
+        //! A public member function (const).
+        /*!
+            i番目の列の名前を返す
+            \param i 列の番号
+            \return i番目の列の名前
+        */
+        std::string_view name(std::size_t i) const noexcept
+        {
+            return std::string_view(reinterpret_cast<char const *>(bytes() + sizeof(ResultHeader) + i * ResultHeader::NAMESIZE));
+        }
+
+        // #endregion publicメンバ関数
+
+        // #region privateメンバ関数
+
+    private:
+        //! A private member function (const).
+        /*!
+            マップした領域の先頭を返す
+            \return マップした領域の先頭
+        */
+        unsigned char const * bytes() const noexcept
+        {
+            return static_cast<unsigned char const *>(addr_);
+        }
+
+        //! A private member function (const).
+        /*!
+            ヘッダと列の配置がファイルの大きさと矛盾しないかどうかを調べる
+            \return 正しい形式のファイルかどうか
+        */
+        bool isvalid() const noexcept
+        {
+            if (length_ < sizeof(ResultHeader)) {
+                return false;
+            }
+
+            auto const & h(header());
+            if (h.magic != ResultHeader::MAGIC || h.version != ResultHeader::VERSION ||
+                h.byteorder != ResultHeader::BYTEORDER || h.namesize != ResultHeader::NAMESIZE || !h.ncolumn) {
+                return false;
+            }
+
+            // 列の名前はNUL終端されていなければならない
+            if (sizeof(ResultHeader) + static_cast<std::size_t>(h.ncolumn) * ResultHeader::NAMESIZE > length_) {
+                return false;
+            }
+
+            for (auto i = 0U; i < h.ncolumn; i++) {
+                if (!std::memchr(bytes() + sizeof(ResultHeader) + i * ResultHeader::NAMESIZE, '\0', ResultHeader::NAMESIZE)) {
+                    return false;
+                }
+            }
+
+            // 最後の列がファイルに収まっていなければならない
+            return h.offset % ResultHeader::ALIGNMENT == 0 && h.stride % ResultHeader::ALIGNMENT == 0 &&
+                h.stride >= h.nrow * sizeof(double) &&
+                h.offset + (h.ncolumn - 1) * h.stride + h.nrow * sizeof(double) <= length_;
+        }
+
+        //! A private member function.
+        /*!
+            メモリマップを解除し、ハンドルを閉じる
+        */
+        void release() noexcept
+        {
+#ifdef _WIN32
+            if (addr_) {
+                UnmapViewOfFile(addr_);
+            }
+
+            if (mapping_) {
+                CloseHandle(mapping_);
+            }
+
+            if (file_ != INVALID_HANDLE_VALUE) {
+                CloseHandle(file_);
+            }
+
+            mapping_ = nullptr;
+            file_ = INVALID_HANDLE_VALUE;
+#else
+            if (addr_) {
+                munmap(addr_, length_);
+            }
+#endif
+            addr_ = nullptr;
+        }
+
+        // #endregion privateメンバ関数
+
+        // #region メンバ変数
+
+        //! A private member variable.
+        /*!
+            マップした領域の先頭
+        */
+        void * addr_ = nullptr;
+
+        //! A private member variable.
+        /*!
+            ファイルの大きさ（バイト）
+        */
+        std::size_t length_ = 0;
+
+#ifdef _WIN32
+        //! A private member variable.
+        /*!
+            ファイルのハンドル
+        */
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+
+        //! A private member variable.
+        /*!
+            ファイルマッピングオブジェクトのハンドル
+        */
+        HANDLE mapping_ = nullptr;
+#endif
+
+        // #endregion メンバ変数
+
+        // #region 禁止されたコンストラクタ・メンバ関数
+
+    public:
+        //! A default constructor (deleted).
+        /*!
+            デフォルトコンストラクタ（禁止）
+        */
+        MappedResult() = delete;
+
+        //! A copy constructor (deleted).
+        /*!
+            コピーコンストラクタ（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+        */
+        MappedResult(MappedResult const & dummy) = delete;
+
+        //! A public member function (deleted).
+        /*!
+            operator=()の宣言（禁止）
+            \param dummy コピー元のオブジェクト（未使用）
+            \return コピー元のオブジェクト
+        */
+        MappedResult & operator=(MappedResult const & dummy) = delete;
+
+        // #endregion 禁止されたコンストラクタ・メンバ関数
+    };
+}
+
+#endif  // _MAPPEDRESULT_H_
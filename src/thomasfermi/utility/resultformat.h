@@ -0,0 +1,152 @@
+﻿/*! \file resultformat.h
+    \brief 計算結果のバイナリファイル（メモリマップして読める形式）のヘッダの宣言
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _RESULTFORMAT_H_
+#define _RESULTFORMAT_H_
+
+#pragma once
+
+#include <array>        // for std::array
+#include <cstddef>      // for std::size_t
+#include <cstdint>      // for std::uint32_t, std::uint64_t
+#include <type_traits>  // for std::is_trivially_copyable_v
+
+namespace utility {
+    //! A struct.
+    /*!
+        計算結果のバイナリファイルの先頭に置くヘッダ
+        ファイルの構成は
+            ヘッダ（sizeof(ResultHeader)バイト）
+            列の名前（NAMESIZEバイトのNUL終端文字列がncolumn個）
+            offsetバイト目から、strideバイトおきにncolumn個の列（各列はnrow個のdouble）
+        で、各列の先頭はALIGNMENTバイト境界に揃えてある
+        値はすべて書き出した計算機のバイト順で格納する（byteorderで判定できる）
+    */
+    struct ResultHeader final {
+        // #region メンバ変数
+
+        //! A public member variable (constant expression).
+        /*!
+            列の先頭を揃える境界（バイト）
+        */
+        static std::size_t constexpr ALIGNMENT = 64U;
+
+        //! A public member variable (constant expression).
+        /*!
+            バイト順を判定するための値
+        */
+        static std::uint32_t constexpr BYTEORDER = 0x01020304U;
+
+        //! A public member variable (constant expression).
+        /*!
+            ファイルの先頭の識別子
+        */
+        static std::array<char, 8> constexpr MAGIC = { 'T', 'F', 'R', 'E', 'S', 'U', 'L', 'T' };
+
+        //! A public member variable (constant expression).
+        /*!
+            列の名前の領域のサイズ（バイト）
+        */
+        static std::uint32_t constexpr NAMESIZE = 32U;
+
+        //! A public member variable (constant expression).
+        /*!
+            形式のバージョン
+        */
+        static std::uint32_t constexpr VERSION = 1U;
+
+        //! A public member variable.
+        /*!
+            ファイルの先頭の識別子（MAGIC）
+        */
+        std::array<char, 8> magic;
+
+        //! A public member variable.
+        /*!
+            形式のバージョン（VERSION）
+        */
+        std::uint32_t version;
+
+        //! A public member variable.
+        /*!
+            書き出した計算機のバイト順で格納したBYTEORDER
+        */
+        std::uint32_t byteorder;
+
+        //! A public member variable.
+        /*!
+            列の数
+        */
+        std::uint32_t ncolumn;
+
+        //! A public member variable.
+        /*!
+            列の名前の領域のサイズ（NAMESIZE）
+        */
+        std::uint32_t namesize;
+
+        //! A public member variable.
+        /*!
+            行の数
+        */
+        std::uint64_t nrow;
+
+        //! A public member variable.
+        /*!
+            最初の列のファイル先頭からの位置（バイト）
+        */
+        std::uint64_t offset;
+
+        //! A public member variable.
+        /*!
+            隣り合う列の先頭の間隔（バイト）
+        */
+        std::uint64_t stride;
+
+        //! A public member variable.
+        /*!
+            原子番号
+        */
+        double Z;
+
+        //! A public member variable.
+        /*!
+            Thomas-Fermiの長さの単位bの逆数α（x = αr）
+        */
+        double alpha;
+
+        //! A public member variable.
+        /*!
+            メッシュの最初の点（最初の列の最初の値）
+        */
+        double mesh_first;
+
+        //! A public member variable.
+        /*!
+            メッシュの刻み幅（等間隔でない点は最初の列に実際の座標がある）
+        */
+        double mesh_step;
+
+        // #endregion メンバ変数
+    };
+
+    static_assert(std::is_trivially_copyable_v<ResultHeader>, "ResultHeader must be trivially copyable");
+    static_assert(sizeof(ResultHeader) == 80U, "ResultHeader must not have padding");
+}
+
+#endif  // _RESULTFORMAT_H_
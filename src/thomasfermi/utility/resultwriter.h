@@ -0,0 +1,118 @@
+﻿/*! \file resultwriter.h
+    \brief 計算結果をバイナリファイルの形式で書き込む関数の宣言と実装
+    Copyright © 2015-2019 @dc1394 All Rights Reserved.
+
+    This program is free software; you can redistribute it and/or modify it
+    under the terms of the GNU General Public License as published by the Free
+    Software Foundation; either version 3 of the License, or (at your option)
+    any later version.
+
+    This program is distributed in the hope that it will be useful, but WITHOUT
+    ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+    FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+    more details.
+
+    You should have received a copy of the GNU General Public License along
+    with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef _RESULTWRITER_H_
+#define _RESULTWRITER_H_
+
+#pragma once
+
+#include "resultformat.h"
+#include <cstddef>          // for std::size_t
+#include <cstdint>          // for std::uint32_t, std::uint64_t
+#include <cstdio>           // for FILE, std::fwrite
+#include <cstring>          // for std::memcpy, std::strncpy
+#include <initializer_list> // for std::initializer_list
+#include <stdexcept>        // for std::runtime_error
+#include <vector>           // for std::vector
+
+namespace utility {
+    //! A function.
+    /*!
+        バイト数をResultHeader::ALIGNMENTの倍数に切り上げる
+        \param n バイト数
+        \return 切り上げたバイト数
+    */
+    inline std::uint64_t alignresult(std::uint64_t n) noexcept
+    {
+        return (n + ResultHeader::ALIGNMENT - 1) / ResultHeader::ALIGNMENT * ResultHeader::ALIGNMENT;
+    }
+
+    //! A function.
+    /*!
+        計算結果のバイナリ形式（resultformat.hの形式）の大きさを返す
+        \param ncolumn 列の数
+        \param nrow 行の数
+        \return 書き込むバイト数
+    */
+    inline std::uint64_t resultsize(std::size_t ncolumn, std::size_t nrow) noexcept
+    {
+        return alignresult(sizeof(ResultHeader) + ncolumn * ResultHeader::NAMESIZE) + ncolumn * alignresult(nrow * sizeof(double));
+    }
+
+    //! A function.
+    /*!
+        列ごとの値を、計算結果のバイナリ形式（resultformat.hの形式）でfpに書き込む
+        書き込むバイト数はresultsize(columns.size(), 列の行数)に等しい
+        書き込みに失敗したときはstd::runtime_errorを投げる
+        \param fp 書き込み先（ファイルでもソケットでもよい）
+        \param names 列の名前
+        \param columns 列（すべて同じ行数）
+        \param Z 原子番号
+        \param alpha x = αrのα
+        \param first メッシュの最初の点
+        \param step メッシュの刻み幅
+    */
+    inline void writeresult(FILE * fp,
+                            std::initializer_list<char const *> names,
+                            std::initializer_list<std::vector<double> const *> columns,
+                            double Z,
+                            double alpha,
+                            double first,
+                            double step)
+    {
+        auto const nrow = (*columns.begin())->size();
+
+        ResultHeader header;
+        header.magic = ResultHeader::MAGIC;
+        header.version = ResultHeader::VERSION;
+        header.byteorder = ResultHeader::BYTEORDER;
+        header.ncolumn = static_cast<std::uint32_t>(columns.size());
+        header.namesize = ResultHeader::NAMESIZE;
+        header.nrow = nrow;
+        header.offset = alignresult(sizeof(ResultHeader) + columns.size() * ResultHeader::NAMESIZE);
+        header.stride = alignresult(nrow * sizeof(double));
+        header.Z = Z;
+        header.alpha = alpha;
+        header.mesh_first = first;
+        header.mesh_step = step;
+
+        // 各列の先頭がALIGNMENTバイト境界に来るように、ヘッダと列の後ろを0で埋める
+        std::vector<char> buf(header.offset, '\0');
+        std::memcpy(buf.data(), &header, sizeof(ResultHeader));
+
+        auto pos = sizeof(ResultHeader);
+        for (auto const name : names) {
+            std::strncpy(buf.data() + pos, name, ResultHeader::NAMESIZE - 1);
+            pos += ResultHeader::NAMESIZE;
+        }
+
+        auto ok = std::fwrite(buf.data(), 1, buf.size(), fp) == buf.size();
+
+        std::vector<char> const padding(header.stride - nrow * sizeof(double), '\0');
+        for (auto const column : columns) {
+            ok = ok && std::fwrite(column->data(), sizeof(double), nrow, fp) == nrow;
+            ok = ok && std::fwrite(padding.data(), 1, padding.size(), fp) == padding.size();
+        }
+
+        if (!ok) {
+            throw std::runtime_error("ファイルに書き込めませんでした。");
+        }
+    }
+}
+
+#endif  // _RESULTWRITER_H_